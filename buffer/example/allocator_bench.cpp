@@ -0,0 +1,336 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/byte.hpp"
+#include "buffer/pool/pool_byte_buffer_allocator.hpp"
+
+// 用法: allocator_bench [线程数] [每个线程的操作数] [随机数种子]
+// 每个(分配器, 场景)组合在单独的子进程中运行, 峰值RSS互不影响
+
+//每隔LATENCY_SAMPLE次操作记录一次耗时
+static const std::size_t LATENCY_SAMPLE = 16;
+//本地场景中每个线程同时持有的block数量
+static const std::size_t LIVE_BLOCKS = 1024;
+//生产者-消费者之间队列的长度
+static const std::size_t RING_LEN = 4096;
+
+struct PoolBackend
+{
+    static const char *name() { return "pool"; }
+    PoolByteBufferAllocator<Byte> allocator;
+    Byte *allocate(std::size_t n) { return allocator.allocate(n); }
+    void deallocate(Byte *p, std::size_t n) { allocator.deallocate(p, n); }
+};
+
+struct MallocBackend
+{
+    static const char *name() { return "malloc"; }
+    Byte *allocate(std::size_t n) { return (Byte *)std::malloc(n); }
+    void deallocate(Byte *p, std::size_t n) { std::free(p); }
+};
+
+struct StdBackend
+{
+    static const char *name() { return "std::allocator"; }
+    std::allocator<Byte> allocator;
+    Byte *allocate(std::size_t n) { return allocator.allocate(n); }
+    void deallocate(Byte *p, std::size_t n) { allocator.deallocate(p, n); }
+};
+
+//请求大小分布, 大部分为小的报文, 少量大的批量传输
+class SizeDistribution
+{
+private:
+    std::mt19937_64 _rng;
+    std::discrete_distribution<int> _bucket{60, 25, 12, 3};
+
+public:
+    explicit SizeDistribution(std::uint64_t seed) : _rng(seed) {}
+
+    std::size_t next()
+    {
+        static const std::size_t bounds[][2] = {{16, 512}, {512, 4096}, {4096, 64 * 1024}, {64 * 1024, 1024 * 1024}};
+        auto &b = bounds[_bucket(_rng)];
+        return std::uniform_int_distribution<std::size_t>(b[0], b[1])(_rng);
+    }
+};
+
+struct Block
+{
+    Byte *data;
+    std::size_t size;
+};
+
+//单生产者单消费者的环形队列
+class Ring
+{
+private:
+    Block _blocks[RING_LEN];
+    std::atomic<std::size_t> _head{0};
+    std::atomic<std::size_t> _tail{0};
+
+public:
+    bool push(const Block &block)
+    {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == RING_LEN)
+        {
+            return false;
+        }
+        _blocks[tail % RING_LEN] = block;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Block &block)
+    {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        block = _blocks[head % RING_LEN];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+class Latency
+{
+private:
+    std::vector<std::uint32_t> _samples;
+    std::size_t _count = 0;
+    std::chrono::steady_clock::time_point _start;
+
+public:
+    bool begin()
+    {
+        if (_count++ % LATENCY_SAMPLE != 0)
+        {
+            return false;
+        }
+        _start = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void end()
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+        _samples.push_back((std::uint32_t)ns);
+    }
+
+    void merge(const Latency &other)
+    {
+        _samples.insert(_samples.end(), other._samples.begin(), other._samples.end());
+    }
+
+    std::uint32_t percentile(double p)
+    {
+        if (_samples.empty())
+        {
+            return 0;
+        }
+        std::size_t idx = (std::size_t)(p * (_samples.size() - 1));
+        std::nth_element(_samples.begin(), _samples.begin() + idx, _samples.end());
+        return _samples[idx];
+    }
+};
+
+template <typename Backend>
+Byte *timed_allocate(Backend &backend, std::size_t size, Latency &latency)
+{
+    if (!latency.begin())
+    {
+        return backend.allocate(size);
+    }
+    Byte *p = backend.allocate(size);
+    latency.end();
+    return p;
+}
+
+template <typename Backend>
+void timed_deallocate(Backend &backend, const Block &block, Latency &latency)
+{
+    if (!latency.begin())
+    {
+        backend.deallocate(block.data, block.size);
+        return;
+    }
+    backend.deallocate(block.data, block.size);
+    latency.end();
+}
+
+//每个线程持有LIVE_BLOCKS个block, 随机替换其中一个, 申请和释放都在本线程
+template <typename Backend>
+void local_churn(std::size_t thread_idx, std::size_t ops, std::uint64_t seed, Latency &latency)
+{
+    Backend backend;
+    SizeDistribution sizes(seed + thread_idx);
+    std::mt19937_64 rng(seed ^ (thread_idx + 1));
+    std::vector<Block> live(LIVE_BLOCKS, Block{nullptr, 0});
+    for (std::size_t i = 0; i < ops / 2; i++)
+    {
+        Block &slot = live[rng() % LIVE_BLOCKS];
+        if (slot.data != nullptr)
+        {
+            timed_deallocate(backend, slot, latency);
+        }
+        slot.size = sizes.next();
+        slot.data = timed_allocate(backend, slot.size, latency);
+        //写入首尾字节, 保证内存被真正使用
+        slot.data[0] = Byte(1);
+        slot.data[slot.size - 1] = Byte(1);
+    }
+    for (auto &slot : live)
+    {
+        if (slot.data != nullptr)
+        {
+            backend.deallocate(slot.data, slot.size);
+        }
+    }
+}
+
+//偶数线程申请, 通过环形队列交给下一个线程释放
+template <typename Backend>
+void producer_consumer(std::size_t thread_idx, std::size_t ops, std::uint64_t seed, Latency &latency, Ring *rings, std::atomic<std::size_t> *done)
+{
+    Backend backend;
+    Ring &ring = rings[thread_idx / 2];
+    if (thread_idx % 2 == 0)
+    {
+        SizeDistribution sizes(seed + thread_idx);
+        for (std::size_t i = 0; i < ops; i++)
+        {
+            Block block;
+            block.size = sizes.next();
+            block.data = timed_allocate(backend, block.size, latency);
+            block.data[0] = Byte(1);
+            while (!ring.push(block))
+            {
+                std::this_thread::yield();
+            }
+        }
+        done[thread_idx / 2].store(1, std::memory_order_release);
+    }
+    else
+    {
+        Block block;
+        while (true)
+        {
+            if (ring.pop(block))
+            {
+                timed_deallocate(backend, block, latency);
+            }
+            else if (done[thread_idx / 2].load(std::memory_order_acquire) != 0)
+            {
+                //生产者结束后队列中可能还有剩余
+                if (!ring.pop(block))
+                {
+                    break;
+                }
+                timed_deallocate(backend, block, latency);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+template <typename Backend>
+void run(const char *scenario, std::size_t num_threads, std::size_t ops, std::uint64_t seed)
+{
+    std::vector<Latency> latencies(num_threads);
+    std::vector<std::thread> threads;
+    std::unique_ptr<Ring[]> rings(new Ring[(num_threads + 1) / 2]);
+    std::unique_ptr<std::atomic<std::size_t>[]> done(new std::atomic<std::size_t>[(num_threads + 1) / 2]);
+    for (std::size_t i = 0; i < (num_threads + 1) / 2; i++)
+    {
+        done[i].store(0);
+    }
+    bool cross = std::string(scenario) == "producer/consumer";
+
+    auto t1 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < num_threads; i++)
+    {
+        threads.emplace_back([&, i]()
+                             {
+                                 if (cross)
+                                 {
+                                     producer_consumer<Backend>(i, ops, seed, latencies[i], rings.get(), done.get());
+                                 }
+                                 else
+                                 {
+                                     local_churn<Backend>(i, ops, seed, latencies[i]);
+                                 }
+                             });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    Latency all;
+    for (auto &latency : latencies)
+    {
+        all.merge(latency);
+    }
+    // 生产者-消费者场景中每对线程完成ops次申请和ops次释放
+    double total_ops = cross ? (double)(num_threads / 2) * 2 * ops : (double)num_threads * ops;
+    double seconds = std::chrono::duration<double>(t2 - t1).count();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::printf("%-18s %-16s %14.0f %10u %10u %12ld\n", scenario, Backend::name(), total_ops / seconds,
+                all.percentile(0.5), all.percentile(0.99), usage.ru_maxrss / 1024);
+    std::fflush(stdout);
+}
+
+template <typename Backend>
+void run_in_child(const char *scenario, std::size_t num_threads, std::size_t ops, std::uint64_t seed)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        run<Backend>(scenario, num_threads, ops, seed);
+        std::_Exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+int main(int argc, char const *argv[])
+{
+    std::size_t num_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+    std::size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000 * 1000;
+    std::uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20240601;
+    //生产者-消费者场景需要成对的线程
+    num_threads = std::max<std::size_t>(2, num_threads + num_threads % 2);
+
+    std::printf("threads=%zu ops/thread=%zu seed=%llu\n", num_threads, ops, (unsigned long long)seed);
+    std::printf("%-18s %-16s %14s %10s %10s %12s\n", "scenario", "allocator", "ops/sec", "p50(ns)", "p99(ns)", "peak_rss(MB)");
+    std::fflush(stdout);
+
+    for (auto scenario : {"local", "producer/consumer"})
+    {
+        run_in_child<PoolBackend>(scenario, num_threads, ops, seed);
+        run_in_child<MallocBackend>(scenario, num_threads, ops, seed);
+        run_in_child<StdBackend>(scenario, num_threads, ops, seed);
+    }
+    return 0;
+}
@@ -1,8 +1,265 @@
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "buffer/byte.hpp"
 #include "buffer/byte_buffer.hpp"
+#include "buffer/byte_search.hpp"
+
+//reserve之后容量不小于请求的大小, 自动扩容模式下追加写入超过容量时按2倍扩容并保留内容, 否则截断
+int growth()
+{
+    ByteBuffer bb;
+    bb.reserve(100);
+    std::cout << "reserve(100): cap = " << bb.cap() << std::endl;
+    if (bb.cap() < 100)
+    {
+        return 1;
+    }
+    bb.reserve(10);
+    if (bb.cap() < 100)
+    {
+        return 1;
+    }
+
+    bb.set_growable(true);
+    std::size_t cap = bb.cap();
+    for (int i = 0; i < 1000; i++)
+    {
+        bb.write<int>(i);
+        if (bb.cap() != cap)
+        {
+            std::cout << "grow at write index " << bb.write_index() << ": " << cap << " -> " << bb.cap() << std::endl;
+            if (bb.cap() < cap * 2)
+            {
+                return 1;
+            }
+            cap = bb.cap();
+        }
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        if (bb.read<int>() != i)
+        {
+            return 1;
+        }
+    }
+
+    ByteBuffer fixed(6);
+    std::size_t first = fixed.write<int>(1);
+    std::size_t second = fixed.write<int>(2);
+    std::cout << "not growable: wrote " << first << " + " << second << " bytes, cap = " << fixed.cap() << std::endl;
+    return first == 4 && second == 2 && fixed.cap() == 6 ? 0 : 1;
+}
+
+//移动和swap只交换内存不copy内容, 被移走的buffer为空; release交出内存, adopt接管内存
+int ownership()
+{
+    ByteBuffer a(16);
+    a.write<int>(42);
+    Byte *data = a.data();
+
+    ByteBuffer b(std::move(a));
+    std::cout << "move construct: a.cap = " << a.cap() << ", b.readable = " << b.readable() << std::endl;
+    if (a.data() != nullptr || a.cap() != 0 || a.readable() != 0 || b.data() != data || b.read<int>(0) != 42)
+    {
+        return 1;
+    }
+
+    ByteBuffer c;
+    c = std::move(b);
+    if (b.data() != nullptr || b.cap() != 0 || c.data() != data || c.read<int>(0) != 42)
+    {
+        return 1;
+    }
+
+    ByteBuffer d(8);
+    d.write<short>(7);
+    c.swap(d);
+    std::cout << "swap: c.readable = " << c.readable() << ", d.readable = " << d.readable() << std::endl;
+    if (d.data() != data || d.read<int>(0) != 42 || c.read<short>(0) != 7)
+    {
+        return 1;
+    }
+
+    //release之后由调用者负责释放, 或者交给同类型分配器的buffer接管
+    std::size_t cap = d.cap();
+    std::size_t len = d.write_index();
+    Byte *raw = d.release();
+    if (raw != data || d.data() != nullptr || d.cap() != 0 || d.readable() != 0)
+    {
+        return 1;
+    }
+    ByteBuffer e;
+    e.adopt(raw, len, cap);
+    std::cout << "adopt: cap = " << e.cap() << ", readable = " << e.readable() << std::endl;
+    return e.data() == data && e.cap() == cap && e.read<int>() == 42 ? 0 : 1;
+}
+
+//固定字节序的读写与本机字节序无关, varint按每7位一个字节编码, zigzag把绝对值小的负数映射成小的无符号数
+int byte_order()
+{
+    ByteBuffer bb(64);
+    bb.write_u16_be(0x0102);
+    bb.write_u32_le(0x01020304);
+    bb.write_u64_be(0x0102030405060708ULL);
+    const unsigned char be16[] = {0x01, 0x02};
+    const unsigned char le32[] = {0x04, 0x03, 0x02, 0x01};
+    if (std::memcmp(bb.data(), be16, 2) != 0 || std::memcmp(bb.data() + 2, le32, 4) != 0 ||
+        to_integer(bb.data()[6]) != 0x01 || to_integer(bb.data()[13]) != 0x08)
+    {
+        return 1;
+    }
+    if (bb.read_u16_be() != 0x0102 || bb.read_u32_le() != 0x01020304 || bb.read_u64_be() != 0x0102030405060708ULL)
+    {
+        return 1;
+    }
+    //可读大小不足时返回0且不改变read index
+    bb.write_u16_le(0xabcd);
+    if (bb.read_u32_be() != 0 || bb.readable() != 2 || bb.read_u16_le() != 0xabcd)
+    {
+        return 1;
+    }
+    std::int32_t i32 = 0;
+    bb.write_be<std::int32_t>(-2);
+    bb.write_le<std::uint64_t>(UINT64_MAX);
+    std::uint64_t u64 = 0;
+    if (!bb.read_be(i32) || i32 != -2 || !bb.read_le(u64) || u64 != UINT64_MAX || bb.read_le(u64))
+    {
+        return 1;
+    }
+
+    const std::uint64_t values[] = {0, 127, 128, UINT64_MAX};
+    const std::size_t lens[] = {1, 1, 2, 10};
+    for (int i = 0; i < 4; i++)
+    {
+        std::size_t n = bb.write_varint(values[i]);
+        std::uint64_t res = 0;
+        std::cout << "varint " << values[i] << ": " << n << " bytes" << std::endl;
+        if (n != lens[i] || !bb.read_varint(res) || res != values[i])
+        {
+            return 1;
+        }
+    }
+    //数据不完整时读取失败, 不改变read index
+    bb.write<Byte>(to_byte(0x80));
+    if (bb.read_varint(u64) || bb.readable() != 1)
+    {
+        return 1;
+    }
+    bb.read<Byte>();
+    bb.discard_read_bytes();
+
+    const std::int64_t signeds[] = {0, -1, 1, -64, 64, INT64_MIN, INT64_MAX};
+    const std::size_t zlens[] = {1, 1, 1, 1, 2, 10, 10};
+    for (int i = 0; i < 7; i++)
+    {
+        std::size_t n = bb.write_zigzag(signeds[i]);
+        std::int64_t res = 0;
+        if (n != zlens[i] || !bb.read_zigzag(res) || res != signeds[i])
+        {
+            std::cout << "zigzag " << signeds[i] << ": " << n << " bytes" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "byte order and varint ok" << std::endl;
+    return 0;
+}
+
+//设置整理阈值后, discard_read_bytes只在read index不小于cap * ratio时才移动可读内容
+int compaction()
+{
+    ByteBuffer bb(100);
+    bb.set_compact_threshold(0.5);
+    for (int i = 0; i < 20; i++)
+    {
+        bb.write<int>(i);
+    }
+    //read index = 40 < 50, 不移动
+    for (int i = 0; i < 10; i++)
+    {
+        bb.read<int>();
+    }
+    bb.discard_read_bytes();
+    std::cout << "discard at read index 40: compact count = " << bb.compact_count() << std::endl;
+    if (bb.compact_count() != 0 || bb.read_index() != 40)
+    {
+        return 1;
+    }
+    //read index = 52 >= 50, 移动剩余的28字节
+    for (int i = 0; i < 3; i++)
+    {
+        bb.read<int>();
+    }
+    bb.discard_read_bytes();
+    std::cout << "discard at read index 52: compact count = " << bb.compact_count() << ", compacted bytes = " << bb.compacted_bytes() << std::endl;
+    if (bb.compact_count() != 1 || bb.compacted_bytes() != 28 || bb.read_index() != 0 || bb.read<int>() != 13)
+    {
+        return 1;
+    }
+
+    //可写大小不足时先整理再写入, 不扩容
+    for (int i = 0; i < 18; i++)
+    {
+        bb.write<int>(i);
+    }
+    std::size_t cap = bb.cap();
+    if (bb.writable() != 0 || bb.write<int>(18) != 4 || bb.cap() != cap || bb.compact_count() != 2 || bb.read<int>() != 14)
+    {
+        return 1;
+    }
+
+    //阈值为0时每次都移动
+    ByteBuffer eager(100);
+    eager.write<int>(1);
+    eager.write<int>(2);
+    eager.read<int>();
+    eager.discard_read_bytes();
+    return eager.compact_count() == 1 && eager.read_index() == 0 && eager.read<int>() == 2 ? 0 : 1;
+}
+
+//查找按16/32字节一组比较, 匹配位置跨过分组边界或者在最后不足一组的尾部时结果也要正确
+int search()
+{
+    std::cout << "search impl = " << search_impl_name() << std::endl;
+    const char set[] = {';', '|', '#'};
+    for (std::size_t len = 1; len <= 100; len++)
+    {
+        ByteBuffer bb(len + 1);
+        //read index不为0, 查找开始地址不对齐
+        bb.write<char>('-');
+        bb.read<char>();
+        std::string text(len, '.');
+        bb.write<char>(text.data(), len);
+        if (bb.index_of(to_byte('#')) != SEARCH_NPOS || bb.index_of_any<char>(set, 3) != SEARCH_NPOS ||
+            bb.find<char>("#|", 2) != SEARCH_NPOS)
+        {
+            return 1;
+        }
+        for (std::size_t pos = 0; pos < len; pos++)
+        {
+            ByteBuffer hit(len);
+            text.assign(len, '.');
+            text[pos] = '#';
+            if (pos + 1 < len)
+            {
+                text[pos + 1] = '|';
+            }
+            hit.write<char>(text.data(), len);
+            std::size_t pattern = pos + 1 < len ? pos : SEARCH_NPOS;
+            if (hit.index_of(to_byte('#')) != pos || hit.index_of_any<char>(set, 3) != pos ||
+                hit.find<char>("#|", 2) != pattern || hit.index_of(to_byte('#'), pos + 1) != SEARCH_NPOS)
+            {
+                std::cout << "len = " << len << ", pos = " << pos << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "search ok" << std::endl;
+    return 0;
+}
 
 int main(int argc, char const *argv[])
 {
@@ -19,5 +276,31 @@ int main(int argc, char const *argv[])
     std::cout << bb.read<int>(0) << std::endl;
     std::cout << bb.read<int>() << std::endl;
     std::cout << bb.read<int>() << std::endl;
+
+    if (growth() != 0)
+    {
+        std::cout << "growth failed" << std::endl;
+        return 1;
+    }
+    if (ownership() != 0)
+    {
+        std::cout << "ownership failed" << std::endl;
+        return 1;
+    }
+    if (byte_order() != 0)
+    {
+        std::cout << "byte order failed" << std::endl;
+        return 1;
+    }
+    if (compaction() != 0)
+    {
+        std::cout << "compaction failed" << std::endl;
+        return 1;
+    }
+    if (search() != 0)
+    {
+        std::cout << "search failed" << std::endl;
+        return 1;
+    }
     return 0;
 }
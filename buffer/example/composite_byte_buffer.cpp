@@ -0,0 +1,79 @@
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "buffer/byte.hpp"
+#include "buffer/byte_buffer.hpp"
+
+int main(int argc, char const *argv[])
+{
+    //报文头, 报文体和报文尾分别在不同的buffer中, 报文头的第一个字节已经读取
+    ByteBuffer header(16);
+    header.write<char>("#HEAD:", 6);
+    header.read<char>();
+    ByteBuffer body(64);
+    body.write<char>("hello composite buffer", 22);
+    ByteBuffer empty(32);
+    ByteBuffer trailer(8);
+    trailer.write<char>(":END", 4);
+
+    const Byte *bases[] = {header.data() + header.read_index(), body.data(), trailer.data()};
+    const std::size_t lens[] = {5, 22, 4};
+
+    //接管各个buffer的内存, 不copy内容, 没有可读内容的内存块不导出iovec
+    CompositeByteBuffer composite;
+    composite.add_component(std::move(header));
+    composite.add_component(std::move(body));
+    composite.add_component(std::move(empty));
+    composite.add_component(std::move(trailer));
+    std::cout << "components = " << composite.components() << ", readable = " << composite.readable() << std::endl;
+
+    struct iovec iov[8];
+    std::size_t cnt = composite.readable_iovec(iov, 8);
+    std::cout << "iovec count = " << cnt << std::endl;
+    if (cnt != 3 || composite.readable() != 31)
+    {
+        return 1;
+    }
+    for (std::size_t i = 0; i < cnt; i++)
+    {
+        std::cout << "iov[" << i << "] len = " << iov[i].iov_len << std::endl;
+        if ((const Byte *)iov[i].iov_base != bases[i] || iov[i].iov_len != lens[i])
+        {
+            return 1;
+        }
+    }
+
+    //iovec数组不够长时只导出前面的内存块
+    if (composite.readable_iovec(iov, 2) != 2)
+    {
+        return 1;
+    }
+
+    //writev写出一部分后skip, 读完的内存块被释放, 剩余的iovec从下一个位置开始
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return 1;
+    }
+    cnt = composite.readable_iovec(iov, 8);
+    iov[cnt - 1].iov_len = 0;
+    ssize_t n = writev(fds[1], iov, cnt);
+    composite.skip(n);
+    cnt = composite.readable_iovec(iov, 8);
+    std::cout << "after writev(" << n << "): components = " << composite.components() << ", iovec count = " << cnt << std::endl;
+    if (n != 27 || cnt != 1 || iov[0].iov_len != 4 || composite.to_str() != ":END")
+    {
+        return 1;
+    }
+
+    char out[32] = {0};
+    ssize_t r = read(fds[0], out, sizeof(out));
+    close(fds[0]);
+    close(fds[1]);
+    std::cout << std::string(out, r) << std::endl;
+    return std::string(out, r) == "HEAD:hello composite buffer" ? 0 : 1;
+}
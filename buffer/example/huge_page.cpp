@@ -0,0 +1,49 @@
+#include <cstring>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "buffer/byte.hpp"
+#include "buffer/pool/pool_byte_buffer_allocator.hpp"
+
+//反复在两个32MB的block之间memcpy, 比较普通页与大页的耗时
+static void copy(PoolByteBufferAllocator<Byte> &allocator, const char *name)
+{
+    const std::size_t size = 32 * 1024 * 1024;
+    Byte *src = allocator.allocate(size);
+    Byte *dst = allocator.allocate(size);
+    std::memset(src, 1, size);
+    std::memset(dst, 0, size);
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < 100; i++)
+    {
+        std::memcpy(dst, src, size);
+        src[i] = dst[size - 1 - i];
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = t2 - t1;
+    std::cout << name << ": " << 100.0 * size / diff.count() / (1 << 30) << " GB/s" << std::endl;
+
+    allocator.deallocate(src, size);
+    allocator.deallocate(dst, size);
+}
+
+int main(int argc, char const *argv[])
+{
+    auto allocator = PoolByteBufferAllocator<Byte>();
+
+    copy(allocator, "4KB pages");
+
+    //已经缓存的block使用普通页, 先返还给系统
+    allocator.release_memory();
+    allocator.release_memory();
+    PoolByteBufferAllocator<Byte>::set_huge_page_mode(HUGE_PAGE_MODE::TRANSPARENT);
+    copy(allocator, "transparent huge pages");
+
+    allocator.release_memory();
+    allocator.release_memory();
+    PoolByteBufferAllocator<Byte>::set_huge_page_mode(HUGE_PAGE_MODE::EXPLICIT);
+    copy(allocator, "hugetlb pages");
+    return 0;
+}
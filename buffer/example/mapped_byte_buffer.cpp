@@ -0,0 +1,67 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "buffer/mapped_byte_buffer.hpp"
+
+// 用法: mapped_byte_buffer [文件路径]
+// 没有指定文件时先用TRUNCATE模式重新生成一个临时文件, 再用READ_ONLY模式映射并按行解析
+
+int main(int argc, char const *argv[])
+{
+    std::string path = argc > 1 ? argv[1] : "/tmp/mapped_byte_buffer.txt";
+    if (argc <= 1)
+    {
+        //64为文件的总大小, 超过时write只写入一部分
+        MappedByteBuffer out(path, MAP_MODE::TRUNCATE, 64);
+        for (auto line : {"first line\r\n", "second line\r\n", "third line\r\n"})
+        {
+            std::size_t len = std::strlen(line);
+            if (out.write<char>(line, len) != len)
+            {
+                std::cerr << "file is full" << std::endl;
+                return 1;
+            }
+        }
+        out.sync();
+        std::cout << "write " << out.write_index() << " bytes to " << path << std::endl;
+    }
+
+    //共享映射上discard_read_bytes不移动内容, 已读的部分仍然保留在文件中
+    if (argc <= 1)
+    {
+        std::string record = path + ".record";
+        {
+            MappedByteBuffer out(record, MAP_MODE::TRUNCATE, 14);
+            out.write<char>("header:payload", 14);
+        }
+        {
+            MappedByteBuffer out(record, MAP_MODE::READ_WRITE, 15);
+            char header[7];
+            out.read<char>(header, 7);
+            out.discard_read_bytes();
+            out.write<char>('!');
+        }
+        MappedByteBuffer check(record);
+        std::string content(check.readable(), '\0');
+        check.read<char>(&content[0], content.size());
+        std::cout << record << ": " << content << std::endl;
+        if (content != "header:payload!")
+        {
+            return 1;
+        }
+    }
+
+    MappedByteBuffer in(path);
+    std::cout << "map " << path << " readable=" << in.readable() << std::endl;
+    std::size_t end;
+    while ((end = in.find_crlf()) != SEARCH_NPOS)
+    {
+        std::string line(end, '\0');
+        in.read<char>(&line[0], end);
+        char crlf[2];
+        in.read<char>(crlf, 2);
+        std::cout << line << std::endl;
+    }
+    return 0;
+}
@@ -35,7 +35,7 @@ int main(int argc, char const *argv[])
                 if (data == nullptr)
                 {
                     // std::cout << "data == nullptr" << std::endl;
-                    data = new Byte[1ULL << idx];
+                    data = new Byte[SizeClass().small_index_to_size(idx)];
                 }
                 allocator.free_small(idx, data);
             }
@@ -0,0 +1,26 @@
+#include <iostream>
+#include <vector>
+
+#include "buffer/byte.hpp"
+#include "buffer/pool/pool_byte_buffer_allocator.hpp"
+
+int main(int argc, char const *argv[])
+{
+    auto allocator = PoolByteBufferAllocator<Byte>();
+    std::vector<Byte *> blocks;
+
+    //模拟流量高峰
+    for (size_t i = 0; i < 256; i++)
+    {
+        blocks.push_back(allocator.allocate(64 * 1024));
+    }
+    for (auto block : blocks)
+    {
+        allocator.deallocate(block, 64 * 1024);
+    }
+
+    //第一次调用只记录空闲内存, 第二次调用时仍未被使用的内存返还给系统
+    std::cout << "released: " << allocator.release_memory() << " bytes" << std::endl;
+    std::cout << "released: " << allocator.release_memory() << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include <iostream>
+#include <vector>
+
+#include "buffer/byte.hpp"
+#include "buffer/pool_byte_buffer.hpp"
+
+int main(int argc, char const *argv[])
+{
+    //接收buffer中有三个以长度开头的报文
+    PoolByteBuffer recv(256);
+    for (auto payload : {"hello", "shared", "buffer"})
+    {
+        Byte len = to_byte(std::strlen(payload));
+        recv.write<Byte>(&len, 1);
+        recv.write<char>(payload, std::strlen(payload));
+    }
+
+    //切分报文不copy内容, 所有报文共享接收buffer的内存
+    PoolSharedByteBuffer shared(std::move(recv));
+    std::vector<PoolSharedByteBuffer> frames;
+    while (shared.readable() > 0)
+    {
+        std::size_t len = to_integer<std::size_t>(shared[0]);
+        shared.skip(1);
+        frames.push_back(shared.read_slice(len));
+    }
+
+    for (auto &frame : frames)
+    {
+        std::cout << frame.to_str() << " ref_count=" << frame.ref_count() << std::endl;
+    }
+    //最后一个视图析构时内存返还给内存池
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <x86intrin.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "buffer/byte.hpp"
+#include "buffer/pool/size_class.hpp"
+#include "buffer/pool/pool_byte_buffer_allocator.hpp"
+
+//log2/ceil实现的SMALL size class查找, 作为对比
+class LegacySizeClass
+{
+public:
+    SizeClass::SizeInfo size_info(std::uint64_t size)
+    {
+        if (size <= 2048)
+        {
+            std::uint64_t idx = ceil(std::log2(size));
+            idx = idx < 6 ? 6 : idx;
+            return SizeClass::SizeInfo{PAGE_SIZE_TYPE::SMALL, 1ULL << idx, idx};
+        }
+        else if (size <= 16 * MB)
+        {
+            std::uint64_t idx = (size + 1) / (4 * KB) + 1;
+            return SizeClass::SizeInfo{PAGE_SIZE_TYPE::NORMAL, 4 * KB * idx, idx};
+        }
+        else
+        {
+            return SizeClass::SizeInfo{PAGE_SIZE_TYPE::UNMANAGE, size, 0};
+        }
+    }
+};
+
+template <typename F>
+double cycles_per_op(std::size_t ops, F &&f)
+{
+    auto c1 = __rdtsc();
+    f();
+    auto c2 = __rdtsc();
+    return (double)(c2 - c1) / ops;
+}
+
+int main(int argc, char const *argv[])
+{
+    const std::size_t N = 1000 * 1000 * 10;
+    std::vector<std::uint64_t> sizes(4096);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::uint64_t> dist(1, 2048);
+    for (auto &size : sizes)
+    {
+        size = dist(rng);
+    }
+
+    LegacySizeClass legacy;
+    SizeClass size_class;
+    volatile std::uint64_t sink = 0;
+
+    //每次allocate和deallocate各计算一次size_info
+    auto legacy_cycles = cycles_per_op(N, [&]()
+                                       {
+                                           for (std::size_t i = 0; i < N; i++)
+                                           {
+                                               sink = sink + legacy.size_info(sizes[i & 4095]).free_list_index;
+                                           }
+                                       });
+    auto table_cycles = cycles_per_op(N, [&]()
+                                      {
+                                          for (std::size_t i = 0; i < N; i++)
+                                          {
+                                              sink = sink + size_class.size_info(sizes[i & 4095]).free_list_index;
+                                          }
+                                      });
+
+    auto allocator = PoolByteBufferAllocator<Byte>();
+    auto alloc_cycles = cycles_per_op(N, [&]()
+                                      {
+                                          for (std::size_t i = 0; i < N; i++)
+                                          {
+                                              auto size = sizes[i & 4095];
+                                              Byte *data = allocator.allocate(size);
+                                              allocator.deallocate(data, size);
+                                          }
+                                      });
+
+    std::cout << "size_info (log2):  " << legacy_cycles << " cycles/op" << std::endl;
+    std::cout << "size_info (table): " << table_cycles << " cycles/op" << std::endl;
+    std::cout << "allocate + deallocate: " << alloc_cycles << " cycles/op, "
+              << "size_info saved per pair: " << 2 * (legacy_cycles - table_cycles) << " cycles" << std::endl;
+    return 0;
+}
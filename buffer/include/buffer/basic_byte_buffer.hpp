@@ -4,9 +4,12 @@
 #include <cstring>
 #include <cinttypes>
 #include <memory>
+#include <utility>
 
 #include "buffer/byte.hpp"
 #include "buffer/type_traits.hpp"
+#include "buffer/endian.hpp"
+#include "buffer/byte_search.hpp"
 
 template <typename T, typename Alloc, typename Enable = void>
 class BasicByteBuffer
@@ -22,8 +25,33 @@ protected:
     std::size_t _cap = 0;
     T *_bytes = nullptr;
     Alloc _allocator;
+    //写入超过可写大小时是否自动扩容
+    bool _growable = false;
+    //read index超过容量的这个比例时才在discard_read_bytes中整理内存, 0表示每次都整理
+    double _compact_threshold = 0;
+    //整理内存时移动的字节数和次数
+    std::size_t _compact_bytes = 0;
+    std::size_t _compact_count = 0;
 
     void recreate_data(std::size_t cap);
+    /**
+     * @brief 申请cap大小的新内存, 并将[0, write index)的内容copy到新内存
+     *
+     * @param cap 新的容量
+     */
+    void grow(std::size_t cap);
+    /**
+     * @brief 可写模式下保证[0, end)都在buffer内
+     *
+     * @param end 写入的结束位置
+     */
+    void prepare_write(std::size_t end);
+    /**
+     * @brief 在write index处追加写入n个元素前调用, 延迟整理模式下可写大小不足时先整理内存, 再按自动扩容模式扩容
+     *
+     * @param n 写入长度
+     */
+    void prepare_append(std::size_t n);
 
 public:
     typedef T value_type;
@@ -33,13 +61,54 @@ public:
 public:
     BasicByteBuffer(Alloc a = Alloc());
     BasicByteBuffer(const BasicByteBuffer &other);
+    /**
+     * @brief 移动构造, 接管other的内存, other变为空buffer
+     *
+     * @param other 被移动的buffer
+     */
+    BasicByteBuffer(BasicByteBuffer &&other) noexcept;
     BasicByteBuffer(const T *bytes, std::size_t len, Alloc a = Alloc());
     BasicByteBuffer(const T *bytes, std::size_t len, std::size_t cap, Alloc a = Alloc());
     BasicByteBuffer(std::size_t cap, Alloc a = Alloc());
     virtual ~BasicByteBuffer();
 
+    BasicByteBuffer &operator=(const BasicByteBuffer &other);
+    /**
+     * @brief 移动赋值, 释放当前内存并接管other的内存, other变为空buffer
+     *
+     * @param other 被移动的buffer
+     * @return BasicByteBuffer& 当前buffer
+     */
+    BasicByteBuffer &operator=(BasicByteBuffer &&other) noexcept;
     template <typename T2, typename Alloc2>
     BasicByteBuffer &operator=(const BasicByteBuffer<T2, Alloc2> &other);
+    /**
+     * @brief 交换两个buffer的内存、下标以及分配器, 不copy内容
+     *
+     * @param other 另一个buffer
+     */
+    void swap(BasicByteBuffer &other) noexcept;
+    /**
+     * @brief 交出内存的所有权, buffer变为空buffer, 调用前通过cap()得到内存大小
+     *        返回的内存需要使用get_allocator()得到的分配器释放, 或者通过adopt交给另一个buffer
+     *
+     * @return T* 内存指针, 空buffer返回nullptr
+     */
+    T *release();
+    /**
+     * @brief 接管同类型分配器申请的内存, 释放当前内存, read index为0, write index为len
+     *
+     * @param bytes 内存指针
+     * @param len 数据长度
+     * @param cap 内存大小
+     */
+    void adopt(T *bytes, std::size_t len, std::size_t cap);
+    /**
+     * @brief 得到分配器
+     *
+     * @return Alloc 分配器
+     */
+    Alloc get_allocator() const;
     /**
      * @brief 得到容量
      * 
@@ -58,6 +127,104 @@ public:
      * @return std::size_t 可读大小
      */
     std::size_t readable();
+    /**
+     * @brief read index位置
+     *
+     * @return std::size_t read index
+     */
+    std::size_t read_index();
+    /**
+     * @brief write index位置
+     *
+     * @return std::size_t write index
+     */
+    std::size_t write_index();
+    /**
+     * @brief 设置自动扩容模式, 写入超过可写大小时按2倍扩容并保留已有内容, 否则截断写入
+     *
+     * @param growable 是否自动扩容
+     */
+    void set_growable(bool growable);
+    /**
+     * @brief 是否为自动扩容模式
+     *
+     * @return true 自动扩容
+     * @return false 截断写入
+     */
+    bool growable();
+    /**
+     * @brief 保证容量不小于cap, 扩容时保留已有内容, 容量会对齐到分配器的size class
+     *
+     * @param cap 最小容量
+     */
+    void reserve(std::size_t cap);
+    /**
+     * @brief 保证可写大小不小于n, 容量不足时按2倍扩容, 不受自动扩容模式影响
+     *
+     * @param n 最小可写大小
+     */
+    void ensure_writable(std::size_t n);
+    /**
+     * @brief 设置延迟整理的阈值, 大于0时discard_read_bytes只在read index超过cap * ratio时才移动内容,
+     *        并且追加写入时可写大小不足会先整理内存再扩容, 使长期使用的接收buffer每字节的移动开销均摊为O(1)
+     *
+     * @param ratio 阈值, 范围[0, 1], 0表示每次discard_read_bytes都移动内容
+     */
+    void set_compact_threshold(double ratio);
+    double compact_threshold();
+    /**
+     * @brief 将可读内容移动到开始位置, read index变为0
+     */
+    void compact();
+    /**
+     * @brief 整理内存时累计移动的字节数
+     *
+     * @return std::size_t 移动的字节数
+     */
+    std::size_t compacted_bytes();
+    /**
+     * @brief 整理内存的次数, 不包括没有可读内容时直接重置下标的情况
+     *
+     * @return std::size_t 整理次数
+     */
+    std::size_t compact_count();
+    /**
+     * @brief 在可读范围内查找第一个等于value的元素
+     *
+     * @param value 要查找的元素
+     * @param from 相对于read index的开始位置
+     * @return std::size_t 相对于read index的下标, 未找到返回SEARCH_NPOS
+     */
+    std::size_t index_of(T value, std::size_t from = 0);
+    /**
+     * @brief 在可读范围内查找第一个在set中的字节, 用于查找多种分隔符
+     *
+     * @tparam T2 元素类型, 只能是char, u_char等1字节类型
+     * @param set 元素集合
+     * @param n 集合长度
+     * @param from 相对于read index的开始位置
+     * @return std::size_t 相对于read index的下标, 未找到返回SEARCH_NPOS
+     */
+    template <typename T2>
+    std::size_t index_of_any(const typename is_readable<T2>::type *set, std::size_t n, std::size_t from = 0);
+    /**
+     * @brief 在可读范围内查找第一次出现pattern的位置
+     *
+     * @tparam T2 元素类型
+     * @param pattern 要查找的内容
+     * @param n 内容长度
+     * @param from 相对于read index的开始位置
+     * @return std::size_t 相对于read index的下标, 未找到返回SEARCH_NPOS
+     */
+    template <typename T2>
+    std::size_t find(const typename is_readable<T2>::type *pattern, std::size_t n, std::size_t from = 0);
+    /**
+     * @brief 在可读范围内查找第一个"\r\n", 用于按行解析文本协议
+     *
+     * @param from 相对于read index的开始位置, 上次未找到时可以从readable() - 1继续查找
+     * @return std::size_t '\r'相对于read index的下标, 未找到返回SEARCH_NPOS
+     */
+    std::size_t find_crlf(std::size_t from = 0);
     /**
      * @brief 将buffer内容转换成string
      * 
@@ -91,7 +258,7 @@ public:
      */
     const T *const_data() const;
     /**
-     * @brief 丢弃已经读取的bytes, 并将buffer内容copy到开始位置
+     * @brief 丢弃已经读取的bytes, 没有可读内容时直接重置下标, 否则按延迟整理阈值决定是否将可读内容移动到开始位置
      */
     void discard_read_bytes();
     /**
@@ -138,27 +305,27 @@ public:
      */
     T &operator[](std::size_t i);
     /**
-     * @brief 从index位置读取T2类型元素, 不增加read index, 有可能读取超过可读数量的字节或者读取到buffer外内存
+     * @brief 从read index + index位置读取T2类型元素(本机字节序), 不增加read index, 超过可读大小的字节为0
      * 
      * @tparam T2 读取元素类型, 可以是char,u_char,数字
-     * @tparam N T2大小
+     * @tparam N 读取字节数, 不能超过sizeof(T2)
      * @param index 开始位置
      * @return T2 元素
      */
     template <typename T2, std::size_t N = sizeof(T2)>
     typename is_readable<T2>::type read(std::size_t index);
     /**
-     * @brief 从index位置读取T2类型元素, 并增加read index, 有可能读取超过可读数量的字节或读取到buffer外内存
+     * @brief 读取T2类型元素(本机字节序), 并增加read index, 超过可读大小的字节为0
      * 
      * @tparam T2 读取元素类型, 可以是char,u_char,数字
-     * @tparam N T2大小
+     * @tparam N 读取字节数, 不能超过sizeof(T2)
      * @param index 开始位置
      * @return T2 元素
      */
     template <typename T2, std::size_t N = sizeof(T2)>
     typename is_readable<T2>::type read();
     /**
-     * @brief 写入元素到buffer指定位置, 若超过write index则增加write index, 若元素过大写到buffer外内存, 元素会被截断
+     * @brief 写入元素到buffer指定位置, 若超过write index则增加write index, 若元素过大写到buffer外内存, 元素会被截断, 自动扩容模式下先扩容
      * 
      * @tparam T2 写入元素元素类型
      * @param ele 要写入元素
@@ -169,7 +336,7 @@ public:
     template <typename T2, std::size_t N = sizeof(T2)>
     std::size_t write(const typename is_readable<T2>::type &ele, std::size_t index);
     /**
-     * @brief 追加写入元素, 增加write index, 返回真正写入字节数, 如果元素过大导致超过buffer容量元素会被截断
+     * @brief 追加写入元素, 增加write index, 返回真正写入字节数, 如果元素过大导致超过buffer容量元素会被截断, 自动扩容模式下先扩容
      * 
      * @tparam T2 写入元素元素类型
      * @tparam N 写入元素大小
@@ -189,7 +356,88 @@ public:
     template <typename T2>
     std::size_t read(typename is_readable<T2>::type *dst, std::size_t size);
     /**
-     * @brief 追加写入元素到buffer, 最多写入可写大小
+     * @brief 读取小端序的T2类型元素, 并增加read index
+     *
+     * @tparam T2 整数或浮点数
+     * @param value 读取结果
+     * @return true 读取成功
+     * @return false 可读大小不足, 不改变read index
+     */
+    template <typename T2>
+    typename std::enable_if<std::is_arithmetic<T2>::value, bool>::type read_le(T2 &value);
+    /**
+     * @brief 读取大端序(网络字节序)的T2类型元素, 并增加read index
+     *
+     * @tparam T2 整数或浮点数
+     * @param value 读取结果
+     * @return true 读取成功
+     * @return false 可读大小不足, 不改变read index
+     */
+    template <typename T2>
+    typename std::enable_if<std::is_arithmetic<T2>::value, bool>::type read_be(T2 &value);
+    /**
+     * @brief 以小端序追加写入T2类型元素
+     *
+     * @tparam T2 整数或浮点数
+     * @param value 要写入元素
+     * @return std::size_t 写入字节数, 可写大小不足时不写入并返回0, 自动扩容模式下先扩容
+     */
+    template <typename T2>
+    typename std::enable_if<std::is_arithmetic<T2>::value, std::size_t>::type write_le(T2 value);
+    /**
+     * @brief 以大端序(网络字节序)追加写入T2类型元素
+     *
+     * @tparam T2 整数或浮点数
+     * @param value 要写入元素
+     * @return std::size_t 写入字节数, 可写大小不足时不写入并返回0, 自动扩容模式下先扩容
+     */
+    template <typename T2>
+    typename std::enable_if<std::is_arithmetic<T2>::value, std::size_t>::type write_be(T2 value);
+    //固定字节序的整数读写, 可读大小不足时返回0且不改变read index, 可写大小不足时返回0
+    std::uint16_t read_u16_be();
+    std::uint16_t read_u16_le();
+    std::uint32_t read_u32_be();
+    std::uint32_t read_u32_le();
+    std::uint64_t read_u64_be();
+    std::uint64_t read_u64_le();
+    std::size_t write_u16_be(std::uint16_t value);
+    std::size_t write_u16_le(std::uint16_t value);
+    std::size_t write_u32_be(std::uint32_t value);
+    std::size_t write_u32_le(std::uint32_t value);
+    std::size_t write_u64_be(std::uint64_t value);
+    std::size_t write_u64_le(std::uint64_t value);
+    /**
+     * @brief 追加写入varint编码的无符号整数
+     *
+     * @param value 要写入的值
+     * @return std::size_t 写入字节数, 可写大小不足时不写入并返回0
+     */
+    std::size_t write_varint(std::uint64_t value);
+    /**
+     * @brief 读取varint编码的无符号整数, 并增加read index
+     *
+     * @param value 读取结果
+     * @return true 读取成功
+     * @return false 数据不完整或格式错误, 不改变read index
+     */
+    bool read_varint(std::uint64_t &value);
+    /**
+     * @brief 追加写入zigzag+varint编码的有符号整数, 绝对值小的负数也只占用很少的字节
+     *
+     * @param value 要写入的值
+     * @return std::size_t 写入字节数, 可写大小不足时不写入并返回0
+     */
+    std::size_t write_zigzag(std::int64_t value);
+    /**
+     * @brief 读取zigzag+varint编码的有符号整数, 并增加read index
+     *
+     * @param value 读取结果
+     * @return true 读取成功
+     * @return false 数据不完整或格式错误, 不改变read index
+     */
+    bool read_zigzag(std::int64_t &value);
+    /**
+     * @brief 追加写入元素到buffer, 最多写入可写大小, 自动扩容模式下全部写入
      * 
      * @tparam T2 元素类型
      * @param src 内存位置
@@ -205,11 +453,44 @@ void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::r
 {
     if (_bytes != nullptr)
     {
-        _allocator.deallocate(_bytes, cap);
+        _allocator.deallocate(_bytes, _cap);
     }
     _bytes = _allocator.allocate(cap);
 }
 
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::grow(std::size_t cap)
+{
+    T *bytes = _allocator.allocate(cap);
+    if (_bytes != nullptr)
+    {
+        std::memcpy(bytes, _bytes, _widx);
+        _allocator.deallocate(_bytes, _cap);
+    }
+    _bytes = bytes;
+    _cap = cap;
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::prepare_write(std::size_t end)
+{
+    if (_growable && end > _cap)
+    {
+        ensure_writable(end - _widx);
+    }
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::prepare_append(std::size_t n)
+{
+    //已读部分可以复用时先整理, 扩容时也只需要copy可读内容
+    if (_compact_threshold > 0 && _ridx != 0 && n > writable())
+    {
+        compact();
+    }
+    prepare_write(_widx + n);
+}
+
 template <typename T, typename Alloc>
 BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicByteBuffer(Alloc a) : _allocator(a) {}
 
@@ -221,9 +502,22 @@ BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicB
     _widx = other._widx;
     _ridx = other._ridx;
     _cap = other._cap;
+    _growable = other._growable;
+    _compact_threshold = other._compact_threshold;
     std::memcpy(_bytes, other._bytes, other._cap);
 }
 
+template <typename T, typename Alloc>
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicByteBuffer(BasicByteBuffer &&other) noexcept
+    : _widx(other._widx), _ridx(other._ridx), _cap(other._cap), _bytes(other._bytes), _allocator(std::move(other._allocator)), _growable(other._growable),
+      _compact_threshold(other._compact_threshold), _compact_bytes(other._compact_bytes), _compact_count(other._compact_count)
+{
+    other._widx = 0;
+    other._ridx = 0;
+    other._cap = 0;
+    other._bytes = nullptr;
+}
+
 template <typename T, typename Alloc>
 BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicByteBuffer(const T *bytes, std::size_t len, Alloc a)
 {
@@ -265,6 +559,79 @@ BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::~Basic
     }
 }
 
+template <typename T, typename Alloc>
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type> &
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::operator=(const BasicByteBuffer &other)
+{
+    if (this != &other)
+    {
+        recreate_data(other._cap);
+        _widx = other._widx;
+        _ridx = other._ridx;
+        _cap = other._cap;
+        _growable = other._growable;
+        _compact_threshold = other._compact_threshold;
+        std::memcpy(_bytes, other._bytes, other._cap);
+    }
+    return *this;
+}
+
+template <typename T, typename Alloc>
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type> &
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::operator=(BasicByteBuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        BasicByteBuffer tmp(std::move(other));
+        swap(tmp);
+    }
+    return *this;
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::swap(BasicByteBuffer &other) noexcept
+{
+    std::swap(_widx, other._widx);
+    std::swap(_ridx, other._ridx);
+    std::swap(_cap, other._cap);
+    std::swap(_bytes, other._bytes);
+    std::swap(_allocator, other._allocator);
+    std::swap(_growable, other._growable);
+    std::swap(_compact_threshold, other._compact_threshold);
+    std::swap(_compact_bytes, other._compact_bytes);
+    std::swap(_compact_count, other._compact_count);
+}
+
+template <typename T, typename Alloc>
+T *BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::release()
+{
+    T *bytes = _bytes;
+    _bytes = nullptr;
+    _cap = 0;
+    _widx = 0;
+    _ridx = 0;
+    return bytes;
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::adopt(T *bytes, std::size_t len, std::size_t cap)
+{
+    if (_bytes != nullptr && _bytes != bytes)
+    {
+        _allocator.deallocate(_bytes, _cap);
+    }
+    _bytes = bytes;
+    _cap = cap;
+    _widx = len;
+    _ridx = 0;
+}
+
+template <typename T, typename Alloc>
+Alloc BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::get_allocator() const
+{
+    return _allocator;
+}
+
 template <typename T, typename Alloc>
 template <typename T2, typename Alloc2>
 BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type> &
@@ -275,6 +642,7 @@ BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::operat
     _ridx = other._ridx;
     _cap = other._cap;
     std::memcpy(_bytes, other._bytes, other._cap);
+    return *this;
 }
 
 template <typename T, typename Alloc>
@@ -295,6 +663,127 @@ std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::t
     return _widx - _ridx;
 }
 
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_index()
+{
+    return _ridx;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_index()
+{
+    return _widx;
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::set_growable(bool growable)
+{
+    _growable = growable;
+}
+
+template <typename T, typename Alloc>
+bool BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::growable()
+{
+    return _growable;
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::reserve(std::size_t cap)
+{
+    if (cap > _cap)
+    {
+        //申请的内存大小为size class大小, 多出的部分也可以使用
+        grow(alloc_good_size(_allocator, cap));
+    }
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::ensure_writable(std::size_t n)
+{
+    if (n <= writable())
+    {
+        return;
+    }
+    //按2倍扩容, 使多次追加写入的copy次数均摊为O(1)
+    std::size_t cap = _cap * 2;
+    if (cap < _widx + n)
+    {
+        cap = _widx + n;
+    }
+    reserve(cap);
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::set_compact_threshold(double ratio)
+{
+    _compact_threshold = ratio;
+}
+
+template <typename T, typename Alloc>
+double BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::compact_threshold()
+{
+    return _compact_threshold;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::compacted_bytes()
+{
+    return _compact_bytes;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::compact_count()
+{
+    return _compact_count;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::index_of(T value, std::size_t from)
+{
+    if (from >= readable())
+    {
+        return SEARCH_NPOS;
+    }
+    std::size_t res = search_byte(_bytes + _ridx + from, readable() - from, (std::uint8_t)value);
+    return res == SEARCH_NPOS ? res : from + res;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::index_of_any(const typename is_readable<T2>::type *set, std::size_t n, std::size_t from)
+{
+    static_assert(sizeof(T2) == 1, "index_of_any only supports 1-byte element types");
+    if (from >= readable())
+    {
+        return SEARCH_NPOS;
+    }
+    std::size_t res = search_any(_bytes + _ridx + from, readable() - from, set, n);
+    return res == SEARCH_NPOS ? res : from + res;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::find(const typename is_readable<T2>::type *pattern, std::size_t n, std::size_t from)
+{
+    if (from > readable())
+    {
+        return SEARCH_NPOS;
+    }
+    std::size_t res = search_pattern(_bytes + _ridx + from, readable() - from, pattern, n * sizeof(T2));
+    return res == SEARCH_NPOS ? res : from + res;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::find_crlf(std::size_t from)
+{
+    if (from >= readable())
+    {
+        return SEARCH_NPOS;
+    }
+    std::size_t res = search_crlf(_bytes + _ridx + from, readable() - from);
+    return res == SEARCH_NPOS ? res : from + res;
+}
+
 template <typename T, typename Alloc>
 std::string BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::to_str()
 {
@@ -329,9 +818,33 @@ const T *BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type
 template <typename T, typename Alloc>
 void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::discard_read_bytes()
 {
-    std::memmove(_bytes, _bytes + _ridx, readable());
+    std::size_t rsize = readable();
+    if (rsize == 0)
+    {
+        _ridx = 0;
+        _widx = 0;
+        return;
+    }
+    if (_compact_threshold > 0 && _ridx < _cap * _compact_threshold)
+    {
+        return;
+    }
+    compact();
+}
+
+template <typename T, typename Alloc>
+void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::compact()
+{
+    if (_ridx == 0)
+    {
+        return;
+    }
+    std::size_t rsize = readable();
+    std::memmove(_bytes, _bytes + _ridx, rsize);
     _ridx = 0;
-    _widx -= _ridx;
+    _widx = rsize;
+    _compact_bytes += rsize;
+    _compact_count++;
 }
 
 template <typename T, typename Alloc>
@@ -364,6 +877,7 @@ void BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::r
 template <typename T, typename Alloc>
 std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::fill(const T &ch, std::size_t len)
 {
+    prepare_append(len);
     std::size_t res = writable();
     if (len < res)
     {
@@ -379,6 +893,7 @@ std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::t
 template <typename T, typename Alloc>
 std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::fill(T &&ch, std::size_t len)
 {
+    prepare_append(len);
     std::size_t res = writable();
     if (len < res)
     {
@@ -401,6 +916,7 @@ template <typename T, typename Alloc>
 template <typename T2>
 std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write(const typename is_readable<T2>::type *src, std::size_t size)
 {
+    prepare_append(size);
     std::size_t wsize = writable();
     if (size > wsize)
     {
@@ -440,6 +956,8 @@ template <typename T, typename Alloc>
 template <typename T2, std::size_t N>
 std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write(const typename is_readable<T2>::type &ele)
 {
+    static_assert(N <= sizeof(T2), "write size N must not exceed sizeof(T2)");
+    prepare_append(N);
     std::size_t wsize = writable();
     if (N > wsize)
     {
@@ -457,20 +975,20 @@ template <typename T, typename Alloc>
 template <typename T2, std::size_t N>
 std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write(const typename is_readable<T2>::type &ele, std::size_t index)
 {
-    std::size_t wsize = writable();
-    if (N + index > wsize)
+    static_assert(N <= sizeof(T2), "write size N must not exceed sizeof(T2)");
+    prepare_write(index + N);
+    if (index >= _cap)
     {
-        //写入位置超过可写大小, 截断写入
-        std::memcpy(_bytes + index, &ele, wsize);
-        _widx = _cap;
-        return wsize;
+        return 0;
     }
-    else
+    //写入位置超过容量, 截断写入
+    std::size_t wsize = N < _cap - index ? N : _cap - index;
+    std::memcpy(_bytes + index, &ele, wsize);
+    if (index + wsize > _widx)
     {
-        std::memcpy(_bytes + index, &ele, N);
-        _widx += N;
-        return wsize;
+        _widx = index + wsize;
     }
+    return wsize;
 }
 
 template <typename T, typename Alloc>
@@ -478,7 +996,15 @@ template <typename T2, std::size_t N>
 typename is_readable<T2>::type
 BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read(std::size_t index)
 {
-    T2 res = (T2)(*(_bytes + _ridx + index));
+    static_assert(N <= sizeof(T2), "read size N must not exceed sizeof(T2)");
+    //memcpy不要求地址对齐, 读取N个字节而不是1个字节
+    T2 res;
+    std::memset(&res, 0, sizeof(res));
+    std::size_t rsize = readable();
+    if (index < rsize)
+    {
+        std::memcpy(&res, _bytes + _ridx + index, N < rsize - index ? N : rsize - index);
+    }
     return res;
 }
 
@@ -487,8 +1013,8 @@ template <typename T2, std::size_t N>
 typename is_readable<T2>::type
 BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read()
 {
-
-    T2 res = (T2)(*(_bytes + _ridx));
+    static_assert(N <= sizeof(T2), "read size N must not exceed sizeof(T2)");
+    T2 res = read<T2, N>(0);
     _ridx += N;
     if (_ridx > _widx)
     {
@@ -497,4 +1023,187 @@ BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read()
     return res;
 }
 
+template <typename T, typename Alloc>
+template <typename T2>
+typename std::enable_if<std::is_arithmetic<T2>::value, bool>::type
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_le(T2 &value)
+{
+    if (readable() < sizeof(T2))
+    {
+        return false;
+    }
+    value = endian::load_le<T2>(_bytes + _ridx);
+    _ridx += sizeof(T2);
+    return true;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+typename std::enable_if<std::is_arithmetic<T2>::value, bool>::type
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_be(T2 &value)
+{
+    if (readable() < sizeof(T2))
+    {
+        return false;
+    }
+    value = endian::load_be<T2>(_bytes + _ridx);
+    _ridx += sizeof(T2);
+    return true;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+typename std::enable_if<std::is_arithmetic<T2>::value, std::size_t>::type
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_le(T2 value)
+{
+    prepare_append(sizeof(T2));
+    if (writable() < sizeof(T2))
+    {
+        return 0;
+    }
+    endian::store_le<T2>(_bytes + _widx, value);
+    _widx += sizeof(T2);
+    return sizeof(T2);
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+typename std::enable_if<std::is_arithmetic<T2>::value, std::size_t>::type
+BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_be(T2 value)
+{
+    prepare_append(sizeof(T2));
+    if (writable() < sizeof(T2))
+    {
+        return 0;
+    }
+    endian::store_be<T2>(_bytes + _widx, value);
+    _widx += sizeof(T2);
+    return sizeof(T2);
+}
+
+template <typename T, typename Alloc>
+std::uint16_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_u16_be()
+{
+    std::uint16_t value = 0;
+    read_be(value);
+    return value;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_u16_be(std::uint16_t value)
+{
+    return write_be(value);
+}
+
+template <typename T, typename Alloc>
+std::uint16_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_u16_le()
+{
+    std::uint16_t value = 0;
+    read_le(value);
+    return value;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_u16_le(std::uint16_t value)
+{
+    return write_le(value);
+}
+
+template <typename T, typename Alloc>
+std::uint32_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_u32_be()
+{
+    std::uint32_t value = 0;
+    read_be(value);
+    return value;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_u32_be(std::uint32_t value)
+{
+    return write_be(value);
+}
+
+template <typename T, typename Alloc>
+std::uint32_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_u32_le()
+{
+    std::uint32_t value = 0;
+    read_le(value);
+    return value;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_u32_le(std::uint32_t value)
+{
+    return write_le(value);
+}
+
+template <typename T, typename Alloc>
+std::uint64_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_u64_be()
+{
+    std::uint64_t value = 0;
+    read_be(value);
+    return value;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_u64_be(std::uint64_t value)
+{
+    return write_be(value);
+}
+
+template <typename T, typename Alloc>
+std::uint64_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_u64_le()
+{
+    std::uint64_t value = 0;
+    read_le(value);
+    return value;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_u64_le(std::uint64_t value)
+{
+    return write_le(value);
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_varint(std::uint64_t value)
+{
+    std::uint8_t encoded[endian::VARINT_MAX_LEN];
+    std::size_t n = endian::varint_encode(value, encoded);
+    prepare_append(n);
+    if (writable() < n)
+    {
+        return 0;
+    }
+    std::memcpy(_bytes + _widx, encoded, n);
+    _widx += n;
+    return n;
+}
+
+template <typename T, typename Alloc>
+bool BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_varint(std::uint64_t &value)
+{
+    std::size_t n = endian::varint_decode((const std::uint8_t *)(_bytes + _ridx), readable(), value);
+    _ridx += n;
+    return n != 0;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_zigzag(std::int64_t value)
+{
+    return write_varint(endian::zigzag_encode(value));
+}
+
+template <typename T, typename Alloc>
+bool BasicByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_zigzag(std::int64_t &value)
+{
+    std::uint64_t encoded = 0;
+    if (!read_varint(encoded))
+    {
+        return false;
+    }
+    value = endian::zigzag_decode(encoded);
+    return true;
+}
+
 #endif /* __BASIC_BYTE_BUFFER_HPP__ */
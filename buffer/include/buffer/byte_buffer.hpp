@@ -2,7 +2,11 @@
 #define __BYTE_BUFFER_HPP__
 
 #include "buffer/basic_byte_buffer.hpp"
+#include "buffer/shared_byte_buffer.hpp"
+#include "buffer/composite_byte_buffer.hpp"
 
 typedef BasicByteBuffer<Byte, std::allocator<Byte>> ByteBuffer;
+typedef BasicSharedByteBuffer<Byte, std::allocator<Byte>> SharedByteBuffer;
+typedef BasicCompositeByteBuffer<Byte, std::allocator<Byte>> CompositeByteBuffer;
 
 #endif /* __BYTE_BUFFER_HPP__ */
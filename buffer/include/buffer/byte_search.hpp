@@ -0,0 +1,59 @@
+#ifndef __BYTE_SEARCH_HPP__
+#define __BYTE_SEARCH_HPP__
+
+#include <cinttypes>
+
+// 内存中的字节查找, x86上运行时检测CPU, 使用AVX2(每次32字节)或SSE2(每次16字节)比较, 其他平台使用逐字节查找
+
+//未找到时的返回值
+constexpr const std::size_t SEARCH_NPOS = (std::size_t)-1;
+
+/**
+ * @brief 查找第一个等于value的字节
+ *
+ * @param data 开始地址
+ * @param len 长度
+ * @param value 要查找的字节
+ * @return std::size_t 相对于data的下标, 未找到返回SEARCH_NPOS
+ */
+std::size_t search_byte(const void *data, std::size_t len, std::uint8_t value);
+
+/**
+ * @brief 查找第一个在set中的字节, set不超过16个字节时使用SIMD比较, 否则使用256位的位图逐字节查找
+ *
+ * @param data 开始地址
+ * @param len 长度
+ * @param set 字节集合
+ * @param set_len 字节集合长度
+ * @return std::size_t 相对于data的下标, 未找到或set为空返回SEARCH_NPOS
+ */
+std::size_t search_any(const void *data, std::size_t len, const void *set, std::size_t set_len);
+
+/**
+ * @brief 查找第一次出现pattern的位置, 同时比较pattern的第一个和最后一个字节过滤候选位置, 再用memcmp确认
+ *
+ * @param data 开始地址
+ * @param len 长度
+ * @param pattern 要查找的内容
+ * @param pattern_len 内容长度, 为0时返回0
+ * @return std::size_t 相对于data的下标, 未找到返回SEARCH_NPOS
+ */
+std::size_t search_pattern(const void *data, std::size_t len, const void *pattern, std::size_t pattern_len);
+
+/**
+ * @brief 查找第一个"\r\n"
+ *
+ * @param data 开始地址
+ * @param len 长度
+ * @return std::size_t '\r'相对于data的下标, 未找到返回SEARCH_NPOS
+ */
+std::size_t search_crlf(const void *data, std::size_t len);
+
+/**
+ * @brief 当前使用的实现
+ *
+ * @return const char* "avx2", "sse2"或"scalar"
+ */
+const char *search_impl_name();
+
+#endif /* __BYTE_SEARCH_HPP__ */
@@ -0,0 +1,472 @@
+#ifndef __COMPOSITE_BYTE_BUFFER_HPP__
+#define __COMPOSITE_BYTE_BUFFER_HPP__
+
+#include <sys/uio.h>
+
+#include <cstring>
+#include <cinttypes>
+#include <deque>
+#include <string>
+#include <utility>
+
+#include "buffer/byte.hpp"
+#include "buffer/type_traits.hpp"
+#include "buffer/basic_byte_buffer.hpp"
+
+template <typename T, typename Alloc, typename Enable = void>
+class BasicCompositeByteBuffer
+{
+};
+
+/**
+ * @brief 由多个内存块组成的buffer, 逻辑上是所有内存块可读内容的拼接
+ *        写入超过最后一个内存块时申请新的内存块, 不copy已有内容; 读取完的内存块立即返还给分配器
+ *        可以导出iovec数组, 配合writev/readv使用, 不需要合并成一块连续内存
+ *
+ * @tparam T 元素类型, 大小必须为1
+ * @tparam Alloc 分配器
+ */
+template <typename T, typename Alloc>
+class BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>
+{
+private:
+    //内存块, [begin, end)为可读内容, [end, cap)为可写空间
+    struct Component
+    {
+        T *bytes;
+        std::size_t cap;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::deque<Component> _components;
+    //新内存块的大小
+    std::size_t _chunk_size;
+    std::size_t _readable = 0;
+    //writable_iovec导出的第一个内存块到末尾的内存块数量, commit从这个内存块开始
+    std::size_t _commit_components = 0;
+    Alloc _allocator;
+
+    //申请一个至少size大小的内存块追加到末尾
+    void add_chunk(std::size_t size);
+    //释放第一个内存块
+    void pop_front();
+    /**
+     * @brief 从可读内容的index位置copy size个元素到dst, 不增加read index
+     *
+     * @return std::size_t copy的长度
+     */
+    std::size_t copy_out(std::size_t index, T *dst, std::size_t size) const;
+
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef Alloc allocator_type;
+
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param chunk_size 写入空间不足时申请的内存块大小
+     * @param a 分配器
+     */
+    explicit BasicCompositeByteBuffer(std::size_t chunk_size = 8 * 1024, Alloc a = Alloc());
+    BasicCompositeByteBuffer(const BasicCompositeByteBuffer &) = delete;
+    BasicCompositeByteBuffer &operator=(const BasicCompositeByteBuffer &) = delete;
+    BasicCompositeByteBuffer(BasicCompositeByteBuffer &&other) noexcept;
+    BasicCompositeByteBuffer &operator=(BasicCompositeByteBuffer &&other) noexcept;
+    ~BasicCompositeByteBuffer();
+
+    void swap(BasicCompositeByteBuffer &other) noexcept;
+
+    /**
+     * @brief 可读大小, 所有内存块可读内容的总和
+     *
+     * @return std::size_t 可读大小
+     */
+    std::size_t readable() const;
+    /**
+     * @brief 不申请新内存块时的可写大小, 即最后一个内存块的剩余空间
+     *
+     * @return std::size_t 可写大小
+     */
+    std::size_t writable() const;
+    /**
+     * @brief 内存块数量
+     *
+     * @return std::size_t 内存块数量
+     */
+    std::size_t components() const;
+
+    /**
+     * @brief 将buffer的可读内容作为新的内存块追加到末尾, 接管buffer的内存, 不copy内容
+     *
+     * @param buffer 被接管的buffer, 之后变为空buffer
+     */
+    void add_component(BasicByteBuffer<T, Alloc> &&buffer);
+
+    /**
+     * @brief 追加写入, 空间不足时申请新的内存块, 总是全部写入
+     *
+     * @tparam T2 元素类型
+     * @param src 内存位置
+     * @param size 写入大小
+     * @return std::size_t 写入大小
+     */
+    template <typename T2>
+    std::size_t write(const typename is_readable<T2>::type *src, std::size_t size);
+    /**
+     * @brief 追加写入元素, 元素可以跨越内存块
+     *
+     * @tparam T2 元素类型
+     * @tparam N T2大小
+     * @param ele 要写入元素
+     * @return std::size_t 写入字节数
+     */
+    template <typename T2, std::size_t N = sizeof(T2)>
+    std::size_t write(const typename is_readable<T2>::type &ele);
+    /**
+     * @brief 读取数据到dst, 增加read index, 读取完的内存块返还给分配器
+     *
+     * @tparam T2 读取元素类型, 可以是char, u_char, integral
+     * @param dst 目标地址
+     * @param size 长度
+     * @return std::size_t 读取到的长度, 可能小于指定长度
+     */
+    template <typename T2>
+    std::size_t read(typename is_readable<T2>::type *dst, std::size_t size);
+    /**
+     * @brief 读取T2类型元素并增加read index, 元素可以跨越内存块, 可读大小不足时剩余字节为0
+     *
+     * @tparam T2 读取元素类型
+     * @tparam N T2大小
+     * @return T2 元素
+     */
+    template <typename T2, std::size_t N = sizeof(T2)>
+    typename is_readable<T2>::type read();
+    /**
+     * @brief 从可读内容的index位置读取T2类型元素, 不增加read index
+     *
+     * @tparam T2 读取元素类型
+     * @tparam N T2大小
+     * @param index 相对于read index的位置
+     * @return T2 元素
+     */
+    template <typename T2, std::size_t N = sizeof(T2)>
+    typename is_readable<T2>::type read(std::size_t index) const;
+    /**
+     * @brief 增加read index, 读取完的内存块返还给分配器
+     *
+     * @param n 跳过的长度, 例如writev写出的长度
+     * @return std::size_t 真正跳过的长度
+     */
+    std::size_t skip(std::size_t n);
+    /**
+     * @brief 将可读内容转换成string
+     *
+     * @return std::string 可读内容
+     */
+    std::string to_str() const;
+
+    /**
+     * @brief 导出可读内容的iovec数组, 用于writev, 写出后调用skip
+     *
+     * @param iov iovec数组
+     * @param iovcnt 数组长度
+     * @return std::size_t 填充的iovec数量
+     */
+    std::size_t readable_iovec(struct iovec *iov, std::size_t iovcnt) const;
+    /**
+     * @brief 保证可写空间不小于size, 并导出可写空间的iovec数组, 用于readv, 读入后调用commit
+     *
+     * @param iov iovec数组
+     * @param iovcnt 数组长度
+     * @param size 最小可写空间
+     * @return std::size_t 填充的iovec数量
+     */
+    std::size_t writable_iovec(struct iovec *iov, std::size_t iovcnt, std::size_t size);
+    /**
+     * @brief 将writable_iovec导出的空间中前n个元素标记为可读
+     *
+     * @param n readv读入的长度
+     */
+    void commit(std::size_t n);
+};
+
+template <typename T, typename Alloc>
+BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicCompositeByteBuffer(std::size_t chunk_size, Alloc a)
+    : _chunk_size(chunk_size == 0 ? 1 : chunk_size), _allocator(a) {}
+
+template <typename T, typename Alloc>
+BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicCompositeByteBuffer(BasicCompositeByteBuffer &&other) noexcept
+    : _chunk_size(other._chunk_size), _allocator(other._allocator)
+{
+    swap(other);
+}
+
+template <typename T, typename Alloc>
+BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type> &
+BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::operator=(BasicCompositeByteBuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        BasicCompositeByteBuffer tmp(std::move(other));
+        swap(tmp);
+    }
+    return *this;
+}
+
+template <typename T, typename Alloc>
+BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::~BasicCompositeByteBuffer()
+{
+    while (!_components.empty())
+    {
+        pop_front();
+    }
+}
+
+template <typename T, typename Alloc>
+void BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::swap(BasicCompositeByteBuffer &other) noexcept
+{
+    std::swap(_components, other._components);
+    std::swap(_chunk_size, other._chunk_size);
+    std::swap(_readable, other._readable);
+    std::swap(_commit_components, other._commit_components);
+    std::swap(_allocator, other._allocator);
+}
+
+template <typename T, typename Alloc>
+void BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::add_chunk(std::size_t size)
+{
+    std::size_t cap = alloc_good_size(_allocator, size > _chunk_size ? size : _chunk_size);
+    _components.push_back(Component{_allocator.allocate(cap), cap, 0, 0});
+}
+
+template <typename T, typename Alloc>
+void BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::pop_front()
+{
+    Component &c = _components.front();
+    _allocator.deallocate(c.bytes, c.cap);
+    _readable -= c.end - c.begin;
+    _components.pop_front();
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::readable() const
+{
+    return _readable;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::writable() const
+{
+    return _components.empty() ? 0 : _components.back().cap - _components.back().end;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::components() const
+{
+    return _components.size();
+}
+
+template <typename T, typename Alloc>
+void BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::add_component(BasicByteBuffer<T, Alloc> &&buffer)
+{
+    std::size_t cap = buffer.cap();
+    std::size_t begin = buffer.read_index();
+    std::size_t end = buffer.write_index();
+    T *bytes = buffer.release();
+    if (bytes == nullptr)
+    {
+        return;
+    }
+    //追加在末尾, 之后的写入继续使用它的剩余空间
+    _components.push_back(Component{bytes, cap, begin, end});
+    _readable += end - begin;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write(const typename is_readable<T2>::type *src, std::size_t size)
+{
+    const char *p = (const char *)src;
+    std::size_t remain = size;
+    while (remain > 0)
+    {
+        if (writable() == 0)
+        {
+            add_chunk(remain);
+        }
+        Component &c = _components.back();
+        std::size_t n = c.cap - c.end < remain ? c.cap - c.end : remain;
+        std::memcpy(c.bytes + c.end, p, n);
+        c.end += n;
+        p += n;
+        remain -= n;
+    }
+    _readable += size;
+    return size;
+}
+
+template <typename T, typename Alloc>
+template <typename T2, std::size_t N>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write(const typename is_readable<T2>::type &ele)
+{
+    static_assert(N <= sizeof(T2), "write size N must not exceed sizeof(T2)");
+    return write<char>((const char *)&ele, N);
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::copy_out(std::size_t index, T *dst, std::size_t size) const
+{
+    std::size_t copied = 0;
+    for (auto it = _components.begin(); it != _components.end() && copied < size; ++it)
+    {
+        std::size_t len = it->end - it->begin;
+        if (index >= len)
+        {
+            index -= len;
+            continue;
+        }
+        std::size_t n = len - index < size - copied ? len - index : size - copied;
+        std::memcpy(dst + copied, it->bytes + it->begin + index, n);
+        copied += n;
+        index = 0;
+    }
+    return copied;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read(typename is_readable<T2>::type *dst, std::size_t size)
+{
+    std::size_t n = copy_out(0, (T *)dst, size);
+    skip(n);
+    return n;
+}
+
+template <typename T, typename Alloc>
+template <typename T2, std::size_t N>
+typename is_readable<T2>::type
+BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read()
+{
+    static_assert(N <= sizeof(T2), "read size N must not exceed sizeof(T2)");
+    T2 res = read<T2, N>(0);
+    skip(N);
+    return res;
+}
+
+template <typename T, typename Alloc>
+template <typename T2, std::size_t N>
+typename is_readable<T2>::type
+BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read(std::size_t index) const
+{
+    static_assert(N <= sizeof(T2), "read size N must not exceed sizeof(T2)");
+    T2 res;
+    std::memset(&res, 0, sizeof(res));
+    copy_out(index, (T *)&res, N);
+    return res;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::skip(std::size_t n)
+{
+    std::size_t skipped = 0;
+    while (skipped < n && !_components.empty())
+    {
+        Component &c = _components.front();
+        std::size_t len = c.end - c.begin;
+        if (n - skipped < len)
+        {
+            c.begin += n - skipped;
+            _readable -= n - skipped;
+            skipped = n;
+        }
+        else if (_components.size() == 1)
+        {
+            //保留最后一个内存块用于之后的写入
+            c.begin = 0;
+            c.end = 0;
+            _readable -= len;
+            skipped += len;
+        }
+        else
+        {
+            skipped += len;
+            pop_front();
+        }
+    }
+    return skipped;
+}
+
+template <typename T, typename Alloc>
+std::string BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::to_str() const
+{
+    std::string res(_readable, '\0');
+    copy_out(0, (T *)&res[0], _readable);
+    return res;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::readable_iovec(struct iovec *iov, std::size_t iovcnt) const
+{
+    std::size_t cnt = 0;
+    for (auto it = _components.begin(); it != _components.end() && cnt < iovcnt; ++it)
+    {
+        if (it->end != it->begin)
+        {
+            iov[cnt].iov_base = it->bytes + it->begin;
+            iov[cnt].iov_len = it->end - it->begin;
+            cnt++;
+        }
+    }
+    return cnt;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::writable_iovec(struct iovec *iov, std::size_t iovcnt, std::size_t size)
+{
+    if (iovcnt == 0)
+    {
+        return 0;
+    }
+    if (_components.empty() || writable() < size)
+    {
+        //最后一个内存块的剩余空间和一个新的内存块
+        add_chunk(size - writable());
+    }
+
+    //可写空间从倒数第二个内存块的剩余空间开始
+    std::size_t first = _components.size() - 1;
+    if (first > 0 && _components[first].end == 0 && _components[first - 1].end < _components[first - 1].cap)
+    {
+        first--;
+    }
+    _commit_components = _components.size() - first;
+
+    std::size_t cnt = 0;
+    for (std::size_t i = first; i < _components.size() && cnt < iovcnt; i++)
+    {
+        Component &c = _components[i];
+        iov[cnt].iov_base = c.bytes + c.end;
+        iov[cnt].iov_len = c.cap - c.end;
+        cnt++;
+    }
+    return cnt;
+}
+
+template <typename T, typename Alloc>
+void BasicCompositeByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::commit(std::size_t n)
+{
+    std::size_t i = _components.size() > _commit_components ? _components.size() - _commit_components : 0;
+    for (; i < _components.size() && n > 0; i++)
+    {
+        Component &c = _components[i];
+        std::size_t len = c.cap - c.end < n ? c.cap - c.end : n;
+        c.end += len;
+        _readable += len;
+        n -= len;
+    }
+}
+
+#endif /* __COMPOSITE_BYTE_BUFFER_HPP__ */
@@ -0,0 +1,162 @@
+#ifndef __ENDIAN_HPP__
+#define __ENDIAN_HPP__
+
+#include <cstring>
+#include <cinttypes>
+#include <type_traits>
+
+// 字节序转换以及varint/zigzag编解码
+// 使用memcpy读写, 不要求地址对齐, 编译器会优化成一次load/store加bswap, 所以全部定义为inline
+
+namespace endian
+{
+    inline std::uint8_t bswap(std::uint8_t v) { return v; }
+    inline std::uint16_t bswap(std::uint16_t v) { return __builtin_bswap16(v); }
+    inline std::uint32_t bswap(std::uint32_t v) { return __builtin_bswap32(v); }
+    inline std::uint64_t bswap(std::uint64_t v) { return __builtin_bswap64(v); }
+
+    //与T大小相同的无符号整数类型
+    template <std::size_t N>
+    struct unsigned_of;
+    template <>
+    struct unsigned_of<1> { typedef std::uint8_t type; };
+    template <>
+    struct unsigned_of<2> { typedef std::uint16_t type; };
+    template <>
+    struct unsigned_of<4> { typedef std::uint32_t type; };
+    template <>
+    struct unsigned_of<8> { typedef std::uint64_t type; };
+
+    constexpr bool is_little()
+    {
+        return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+    }
+
+    /**
+     * @brief 从src读取小端序的T, T可以是整数或浮点数
+     */
+    template <typename T>
+    inline T load_le(const void *src)
+    {
+        typedef typename unsigned_of<sizeof(T)>::type U;
+        U u;
+        std::memcpy(&u, src, sizeof(U));
+        if (!is_little())
+        {
+            u = bswap(u);
+        }
+        T v;
+        std::memcpy(&v, &u, sizeof(T));
+        return v;
+    }
+
+    /**
+     * @brief 从src读取大端序(网络字节序)的T, T可以是整数或浮点数
+     */
+    template <typename T>
+    inline T load_be(const void *src)
+    {
+        typedef typename unsigned_of<sizeof(T)>::type U;
+        U u;
+        std::memcpy(&u, src, sizeof(U));
+        if (is_little())
+        {
+            u = bswap(u);
+        }
+        T v;
+        std::memcpy(&v, &u, sizeof(T));
+        return v;
+    }
+
+    //将v以小端序写入dst
+    template <typename T>
+    inline void store_le(void *dst, T v)
+    {
+        typedef typename unsigned_of<sizeof(T)>::type U;
+        U u;
+        std::memcpy(&u, &v, sizeof(U));
+        if (!is_little())
+        {
+            u = bswap(u);
+        }
+        std::memcpy(dst, &u, sizeof(U));
+    }
+
+    //将v以大端序(网络字节序)写入dst
+    template <typename T>
+    inline void store_be(void *dst, T v)
+    {
+        typedef typename unsigned_of<sizeof(T)>::type U;
+        U u;
+        std::memcpy(&u, &v, sizeof(U));
+        if (is_little())
+        {
+            u = bswap(u);
+        }
+        std::memcpy(dst, &u, sizeof(U));
+    }
+
+    //varint编码的最大长度
+    constexpr const std::size_t VARINT_MAX_LEN = 10;
+
+    //有符号整数映射为无符号整数, 绝对值小的数编码后也小: 0, -1, 1, -2 -> 0, 1, 2, 3
+    inline std::uint64_t zigzag_encode(std::int64_t v)
+    {
+        return ((std::uint64_t)v << 1) ^ (std::uint64_t)(v >> 63);
+    }
+
+    inline std::int64_t zigzag_decode(std::uint64_t v)
+    {
+        return (std::int64_t)(v >> 1) ^ -(std::int64_t)(v & 1);
+    }
+
+    /**
+     * @brief varint编码, 每个字节低7位为数据, 最高位表示后面是否还有字节
+     *
+     * @param v 要编码的值
+     * @param dst 目标地址, 至少VARINT_MAX_LEN字节
+     * @return std::size_t 编码后的长度
+     */
+    inline std::size_t varint_encode(std::uint64_t v, std::uint8_t *dst)
+    {
+        std::size_t n = 0;
+        while (v >= 0x80)
+        {
+            dst[n++] = (std::uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        dst[n++] = (std::uint8_t)v;
+        return n;
+    }
+
+    /**
+     * @brief varint解码
+     *
+     * @param src 源地址
+     * @param len 可读长度
+     * @param v 解码结果
+     * @return std::size_t 读取的长度, 数据不完整或超过64位时返回0
+     */
+    inline std::size_t varint_decode(const std::uint8_t *src, std::size_t len, std::uint64_t &v)
+    {
+        std::uint64_t res = 0;
+        for (std::size_t i = 0; i < len && i < VARINT_MAX_LEN; i++)
+        {
+            std::uint8_t b = src[i];
+            //第10个字节只能使用1位
+            if (i == VARINT_MAX_LEN - 1 && b > 1)
+            {
+                return 0;
+            }
+            res |= (std::uint64_t)(b & 0x7f) << (7 * i);
+            if (b < 0x80)
+            {
+                v = res;
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+}
+
+#endif /* __ENDIAN_HPP__ */
@@ -0,0 +1,123 @@
+#ifndef __MAPPED_BYTE_BUFFER_HPP__
+#define __MAPPED_BYTE_BUFFER_HPP__
+
+#include <cinttypes>
+#include <string>
+
+#include "buffer/byte.hpp"
+#include "buffer/basic_byte_buffer.hpp"
+
+/**
+ * @brief 使用mmap申请匿名内存的分配器, MappedByteBuffer释放文件映射时也使用munmap, 所以可以共用
+ */
+class MappedAllocator
+{
+public:
+    typedef Byte value_type;
+
+    Byte *allocate(std::size_t n);
+    void deallocate(Byte *p, std::size_t n);
+    /**
+     * @brief 申请n个元素时真正得到的容量, 按页对齐
+     *
+     * @param n 元素个数
+     * @return std::size_t 容量
+     */
+    std::size_t good_size(std::size_t n) const;
+};
+
+enum class MAP_MODE
+{
+    //私有映射(MAP_PRIVATE), 修改只在本进程可见, 不会写回文件
+    READ_ONLY,
+    //共享映射(MAP_SHARED), 修改写回文件, 保留原来的内容, write index为文件大小, 之后的写入追加到文件末尾
+    READ_WRITE,
+    //与READ_WRITE相同, 但打开时清空文件, 用于重新生成文件
+    TRUNCATE,
+};
+
+enum class MAP_ADVICE
+{
+    NORMAL,
+    //顺序读取, 内核会加大预读并尽快回收已读的页
+    SEQUENTIAL,
+    RANDOM,
+    //马上开始预读
+    WILLNEED,
+};
+
+/**
+ * @brief 映射文件的buffer, 与BasicByteBuffer有相同的读写接口, 文件内容不需要copy就可以解析或发送
+ *        read index为0, write index为文件大小, READ_WRITE和TRUNCATE模式下[文件大小, cap)为可写范围
+ *        与BasicByteBuffer相同, 默认不自动扩容, 超过cap的write只写入可写部分并返回真正写入的大小
+ *        扩容(reserve, ensure_writable或自动扩容)后内容copy到匿名内存, 之后的修改不再写回文件
+ */
+class MappedByteBuffer : public BasicByteBuffer<Byte, MappedAllocator>
+{
+public:
+    MappedByteBuffer();
+    /**
+     * @brief 映射文件, 失败时抛出std::runtime_error
+     *
+     * @param path 文件路径
+     * @param mode 映射模式
+     * @param size READ_WRITE和TRUNCATE模式下映射后文件的总大小(cap), 不是追加写入的大小
+     *             大于文件大小时将文件扩展到size, 可写入size - 文件大小字节, 解除映射时文件截断到write index
+     *             不大于文件大小时不扩展, 没有可写空间, READ_ONLY模式下忽略
+     * @param advice 访问方式提示
+     */
+    explicit MappedByteBuffer(const std::string &path, MAP_MODE mode = MAP_MODE::READ_ONLY, std::size_t size = 0, MAP_ADVICE advice = MAP_ADVICE::SEQUENTIAL);
+    MappedByteBuffer(const MappedByteBuffer &other) = delete;
+    MappedByteBuffer(MappedByteBuffer &&other) noexcept;
+    ~MappedByteBuffer();
+
+    MappedByteBuffer &operator=(const MappedByteBuffer &other) = delete;
+    MappedByteBuffer &operator=(MappedByteBuffer &&other) noexcept;
+
+    /**
+     * @brief 映射模式
+     *
+     * @return MAP_MODE 映射模式
+     */
+    MAP_MODE mode() const;
+    /**
+     * @brief 修改访问方式提示(madvise)
+     *
+     * @param advice 访问方式提示
+     */
+    void advise(MAP_ADVICE advice);
+    /**
+     * @brief READ_WRITE和TRUNCATE模式下将修改同步写回文件(msync), READ_ONLY模式下不做任何操作, 失败时抛出std::runtime_error
+     */
+    void sync();
+    /**
+     * @brief 解除映射, 之后变为空buffer, 析构时会自动解除映射
+     *        READ_WRITE和TRUNCATE模式下构造时扩展过文件的, 将文件截断到write index, 去掉没有写入的部分
+     */
+    void unmap();
+    /**
+     * @brief READ_WRITE和TRUNCATE模式下不移动内容, 也不修改read index和write index
+     *        移动共享映射的内容会直接修改文件, 解除映射时还会按write index截断文件, 删除已读的内容
+     *        READ_ONLY模式下与BasicByteBuffer相同
+     */
+    void discard_read_bytes();
+    /**
+     * @brief READ_WRITE和TRUNCATE模式下不移动内容, READ_ONLY模式下与BasicByteBuffer相同
+     */
+    void compact();
+    /**
+     * @brief READ_WRITE和TRUNCATE模式下忽略, 追加写入时不会整理内容, READ_ONLY模式下与BasicByteBuffer相同
+     *
+     * @param ratio 阈值, 范围[0, 1]
+     */
+    void set_compact_threshold(double ratio);
+
+private:
+    MAP_MODE _mode = MAP_MODE::READ_ONLY;
+    //扩展过文件时保留文件描述符, 用于解除映射时截断文件
+    int _fd = -1;
+    //映射的文件大小
+    std::size_t _file_size = 0;
+};
+
+#endif /* __MAPPED_BYTE_BUFFER_HPP__ */
@@ -0,0 +1,491 @@
+#ifndef __CENTRAL_CACHE_HPP__
+#define __CENTRAL_CACHE_HPP__
+
+#include <mutex>
+#include <atomic>
+#include <cinttypes>
+#include <vector>
+#include <algorithm>
+
+#include "buffer/pool/constant.hpp"
+#include "buffer/pool/system_alloc.hpp"
+#include "buffer/pool/page_map.hpp"
+#include "buffer/pool/pool_stats.hpp"
+
+/**
+ * @brief 所有PageHeap共享的中心缓存, 每个size class一个空闲链表
+ *        PageHeap以batch为单位向中心缓存返还内存, 以及从中心缓存补充内存
+ *        空闲链表为空时从系统申请内存: 一个span能容纳至少2个节点时申请span并切分成多个节点, 否则申请一个节点
+ *        所有内存都来自system_alloc, 可以通过scavenge返还给系统: 单独申请的节点使用munmap, 完全空闲的span使用madvise
+ *
+ * @tparam Node 空闲链表节点类型, 必须有next成员
+ */
+template <typename Node>
+class CentralCache
+{
+private:
+    struct Slot
+    {
+        std::mutex mutex;
+        Node *head = nullptr;
+        std::size_t length = 0;
+        std::size_t batch = 1;
+        std::uint64_t size = 0;
+        //上次scavenge之后length的最小值, 这部分节点一直没有被使用
+        std::size_t low_water = 0;
+        //正在切分的span以及还没有切分的节点数量, 每次只切分一个batch, 物理页在写入时才分配
+        char *span = nullptr;
+        std::size_t span_left = 0;
+        //scavenge释放了物理内存的span, 再次切分时不需要系统调用
+        std::vector<char *> released;
+    };
+
+private:
+    std::size_t _len;
+    Slot *_slots;
+    std::size_t _span_size;
+    //从系统申请内存时使用的NUMA节点
+    std::size_t _node;
+    //从系统申请且还没有返还的字节数
+    std::atomic<std::uint64_t> _system_bytes{0};
+    //从系统申请的span, 析构时返还给系统
+    std::mutex _spans_mutex;
+    std::vector<char *> _spans;
+
+private:
+    /**
+     * @brief 从系统申请一个span切分后放入空闲链表, 未设置span大小时申请一个节点, 调用时必须持有slot锁
+     *
+     * @param slot 空闲链表
+     */
+    void populate(Slot &slot);
+    /**
+     * @brief 节点是否属于某个span
+     */
+    bool in_span(Node *node);
+    /**
+     * @brief 节点所在span的首地址, 调用时必须持有_spans_mutex
+     */
+    char *span_of(Node *node);
+    /**
+     * @brief slot的节点是否从span切分
+     */
+    bool carved(const Slot &slot);
+    /**
+     * @brief 将一直没有被使用的单独申请的节点返还给系统, 调用时必须持有slot锁, 在锁外返还的节点通过first返回
+     *
+     * @param slot 空闲链表
+     * @param bytes 最多返还的字节数
+     * @param first 需要在锁外munmap的链表
+     * @return std::size_t 返还的字节数
+     */
+    std::size_t take_blocks(Slot &slot, std::size_t bytes, Node *&first);
+    /**
+     * @brief 从空闲链表中取出所有节点都空闲的span, 调用时必须持有slot锁
+     *
+     * @param slot 空闲链表
+     * @param bytes 最多返还的字节数
+     * @param spans 需要在锁外madvise的span
+     * @return std::size_t 返还的字节数
+     */
+    std::size_t take_spans(Slot &slot, std::size_t bytes, std::vector<char *> &spans);
+
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param len size class数量
+     * @param index_to_size size class下标转换为内存大小, 用来计算每个size class的batch大小
+     * @param span_size 空闲链表为空时从系统申请的span大小, 为0或者容纳不下2个节点时单独申请节点
+     * @param node 从系统申请内存时使用的NUMA节点
+     */
+    CentralCache(std::size_t len, std::uint64_t (*index_to_size)(std::uint64_t), std::size_t span_size = 0, std::size_t node = 0);
+    ~CentralCache();
+    CentralCache(const CentralCache &) = delete;
+    CentralCache &operator=(const CentralCache &) = delete;
+
+    /**
+     * @brief 每次在PageHeap与中心缓存之间移动的节点数量
+     *
+     * @param index size class下标
+     * @return std::size_t batch大小
+     */
+    std::size_t batch_size(std::uint64_t index);
+    /**
+     * @brief size class的block大小
+     *
+     * @param index size class下标
+     * @return std::uint64_t block大小
+     */
+    std::uint64_t size(std::uint64_t index);
+    /**
+     * @brief 中心缓存中空闲节点数量
+     *
+     * @param index size class下标
+     * @return std::size_t 空闲节点数量
+     */
+    std::size_t length(std::uint64_t index);
+    /**
+     * @brief 将first到last的链表放入中心缓存
+     *
+     * @param index size class下标
+     * @param first 链表头节点
+     * @param last 链表尾节点
+     * @param n 链表长度
+     */
+    void insert_range(std::uint64_t index, Node *first, Node *last, std::size_t n);
+    /**
+     * @brief 从中心缓存取出最多n个节点, 取出的链表以nullptr结尾, 中心缓存为空时尝试切分一个新的span
+     *
+     * @param index size class下标
+     * @param first 取出的链表头节点, 中心缓存为空时为nullptr
+     * @param n 最多取出的节点数量
+     * @return std::size_t 真正取出的节点数量
+     */
+    std::size_t remove_range(std::uint64_t index, Node *&first, std::size_t n);
+    /**
+     * @brief 将上次调用之后一直没有被使用的节点返还给系统, 需要周期性调用
+     *        单独申请的节点munmap, 从span切分的节点只有整个span都空闲时才madvise释放物理内存, span保留用于再次切分
+     *
+     * @param bytes 最多返还的字节数
+     * @return std::size_t 真正返还的字节数
+     */
+    std::size_t scavenge(std::size_t bytes);
+    /**
+     * @brief 将中心缓存的统计信息累加到stats
+     *
+     * @param type size class类型
+     * @param stats 统计信息
+     */
+    void collect(PAGE_SIZE_TYPE type, CentralCacheStats &stats);
+};
+
+template <typename Node>
+CentralCache<Node>::CentralCache(std::size_t len, std::uint64_t (*index_to_size)(std::uint64_t), std::size_t span_size, std::size_t node)
+    : _len(len), _slots(new Slot[len]), _span_size(span_size), _node(node)
+{
+    for (std::size_t i = 0; i < _len; i++)
+    {
+        // 每次移动约TRANSFER_BATCH_BYTES字节, 节点数量限制在[TRANSFER_BATCH_MIN, TRANSFER_BATCH_MAX]
+        std::uint64_t size = index_to_size(i);
+        std::uint64_t batch = size == 0 ? TRANSFER_BATCH_MAX : TRANSFER_BATCH_BYTES / size;
+        if (batch < TRANSFER_BATCH_MIN)
+        {
+            batch = TRANSFER_BATCH_MIN;
+        }
+        else if (batch > TRANSFER_BATCH_MAX)
+        {
+            batch = TRANSFER_BATCH_MAX;
+        }
+        _slots[i].batch = batch;
+        _slots[i].size = size;
+    }
+}
+
+template <typename Node>
+CentralCache<Node>::~CentralCache()
+{
+    for (std::size_t i = 0; i < _len; i++)
+    {
+        Node *node0 = _slots[i].head;
+        while (node0 != nullptr)
+        {
+            Node *node = node0->next;
+            if (!in_span(node0))
+            {
+                system_free(node0, _slots[i].size);
+            }
+            node0 = node;
+        }
+    }
+    delete[] _slots;
+
+    for (auto span : _spans)
+    {
+        system_free(span, _span_size);
+    }
+}
+
+template <typename Node>
+std::size_t CentralCache<Node>::batch_size(std::uint64_t index)
+{
+    return _slots[index].batch;
+}
+
+template <typename Node>
+std::uint64_t CentralCache<Node>::size(std::uint64_t index)
+{
+    return _slots[index].size;
+}
+
+template <typename Node>
+std::size_t CentralCache<Node>::length(std::uint64_t index)
+{
+    std::lock_guard<std::mutex> lock(_slots[index].mutex);
+    return _slots[index].length;
+}
+
+template <typename Node>
+void CentralCache<Node>::insert_range(std::uint64_t index, Node *first, Node *last, std::size_t n)
+{
+    Slot &slot = _slots[index];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    last->next = slot.head;
+    slot.head = first;
+    slot.length += n;
+}
+
+template <typename Node>
+std::size_t CentralCache<Node>::remove_range(std::uint64_t index, Node *&first, std::size_t n)
+{
+    Slot &slot = _slots[index];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (slot.head == nullptr)
+    {
+        populate(slot);
+    }
+    first = slot.head;
+    if (first == nullptr)
+    {
+        return 0;
+    }
+
+    std::size_t count = 1;
+    Node *last = first;
+    while (count < n && last->next != nullptr)
+    {
+        last = last->next;
+        count++;
+    }
+    slot.head = last->next;
+    slot.length -= count;
+    if (slot.length < slot.low_water)
+    {
+        slot.low_water = slot.length;
+    }
+    last->next = nullptr;
+    return count;
+}
+
+template <typename Node>
+std::size_t CentralCache<Node>::scavenge(std::size_t bytes)
+{
+    std::size_t released = 0;
+    for (std::size_t i = 0; i < _len && released < bytes; i++)
+    {
+        Slot &slot = _slots[i];
+        Node *first = nullptr;
+        std::vector<char *> spans;
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if (slot.low_water > 0 && slot.size > 0)
+            {
+                released += carved(slot) ? take_spans(slot, bytes - released, spans) : take_blocks(slot, bytes - released, first);
+            }
+            slot.low_water = slot.length;
+        }
+
+        //在锁外返还给系统
+        while (first != nullptr)
+        {
+            Node *node = first->next;
+            //地址可能被系统重新分配, 先删除映射
+            PageMap::instance()->clear(first);
+            system_free(first, slot.size);
+            _system_bytes.fetch_sub(slot.size, std::memory_order_relaxed);
+            first = node;
+        }
+        //span仍然属于中心缓存, 地址不会被系统重新分配, 不需要删除映射
+        for (auto span : spans)
+        {
+            system_release(span, _span_size);
+            _system_bytes.fetch_sub(_span_size, std::memory_order_relaxed);
+        }
+        if (!spans.empty())
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            slot.released.insert(slot.released.end(), spans.begin(), spans.end());
+        }
+    }
+    return released;
+}
+
+template <typename Node>
+std::size_t CentralCache<Node>::take_blocks(Slot &slot, std::size_t bytes, Node *&first)
+{
+    std::size_t max_n = bytes / slot.size + (bytes % slot.size != 0);
+    std::size_t n = slot.low_water < max_n ? slot.low_water : max_n;
+
+    first = slot.head;
+    Node *last = first;
+    for (std::size_t j = 1; j < n; j++)
+    {
+        last = last->next;
+    }
+    slot.head = last->next;
+    slot.length -= n;
+    last->next = nullptr;
+    return n * slot.size;
+}
+
+template <typename Node>
+std::size_t CentralCache<Node>::take_spans(Slot &slot, std::size_t bytes, std::vector<char *> &spans)
+{
+    //一直没有被使用的节点不足一个span时, 不可能有整个空闲的span
+    std::size_t per_span = _span_size / slot.size;
+    std::size_t max_spans = slot.low_water / per_span;
+    std::size_t max_bytes = bytes / _span_size + (bytes % _span_size != 0);
+    max_spans = max_spans < max_bytes ? max_spans : max_bytes;
+    if (max_spans == 0)
+    {
+        return 0;
+    }
+
+    //统计空闲链表中每个span的节点数量, 正在切分的span不参与
+    std::vector<char *> owners;
+    owners.reserve(slot.length);
+    {
+        std::lock_guard<std::mutex> lock(_spans_mutex);
+        for (Node *node = slot.head; node != nullptr; node = node->next)
+        {
+            char *span = span_of(node);
+            if (span != nullptr && !(span == slot.span && slot.span_left != 0))
+            {
+                owners.push_back(span);
+            }
+        }
+    }
+    std::sort(owners.begin(), owners.end());
+    for (auto it = owners.begin(); it != owners.end() && spans.size() < max_spans;)
+    {
+        auto next = std::upper_bound(it, owners.end(), *it);
+        if ((std::size_t)(next - it) == per_span)
+        {
+            spans.push_back(*it);
+        }
+        it = next;
+    }
+    if (spans.empty())
+    {
+        return 0;
+    }
+
+    //从空闲链表删除这些span的节点, spans已经有序
+    Node **prev = &slot.head;
+    while (*prev != nullptr)
+    {
+        Node *node = *prev;
+        auto it = std::upper_bound(spans.begin(), spans.end(), (char *)node);
+        if (it != spans.begin() && (char *)node < *(it - 1) + _span_size)
+        {
+            *prev = node->next;
+        }
+        else
+        {
+            prev = &node->next;
+        }
+    }
+    slot.length -= spans.size() * per_span;
+    return spans.size() * _span_size;
+}
+
+template <typename Node>
+void CentralCache<Node>::populate(Slot &slot)
+{
+    if (slot.size == 0)
+    {
+        return;
+    }
+    if (!carved(slot))
+    {
+        Node *node = (Node *)system_alloc(slot.size, _node);
+        if (node != nullptr)
+        {
+            node->next = slot.head;
+            slot.head = node;
+            slot.length++;
+            _system_bytes.fetch_add(slot.size, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    std::size_t per_span = _span_size / slot.size;
+    if (slot.span_left == 0)
+    {
+        //优先复用scavenge释放了物理内存的span, 仍然保留申请时的NUMA策略
+        char *span = nullptr;
+        if (!slot.released.empty())
+        {
+            span = slot.released.back();
+            slot.released.pop_back();
+        }
+        else
+        {
+            span = (char *)system_alloc(_span_size, _node);
+            if (span == nullptr)
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(_spans_mutex);
+            _spans.insert(std::upper_bound(_spans.begin(), _spans.end(), span), span);
+        }
+        _system_bytes.fetch_add(_span_size, std::memory_order_relaxed);
+        slot.span = span;
+        slot.span_left = per_span;
+    }
+
+    //按size切分一个batch, 相邻的block在链表中也相邻
+    std::size_t n = slot.span_left < slot.batch ? slot.span_left : slot.batch;
+    char *begin = slot.span + (per_span - slot.span_left) * slot.size;
+    for (std::size_t i = 0; i + 1 < n; i++)
+    {
+        ((Node *)(begin + i * slot.size))->next = (Node *)(begin + (i + 1) * slot.size);
+    }
+    ((Node *)(begin + (n - 1) * slot.size))->next = slot.head;
+    slot.head = (Node *)begin;
+    slot.length += n;
+    slot.span_left -= n;
+}
+
+template <typename Node>
+bool CentralCache<Node>::in_span(Node *node)
+{
+    std::lock_guard<std::mutex> lock(_spans_mutex);
+    return span_of(node) != nullptr;
+}
+
+template <typename Node>
+char *CentralCache<Node>::span_of(Node *node)
+{
+    auto it = std::upper_bound(_spans.begin(), _spans.end(), (char *)node);
+    if (it == _spans.begin())
+    {
+        return nullptr;
+    }
+    --it;
+    return (char *)node < *it + _span_size ? *it : nullptr;
+}
+
+template <typename Node>
+bool CentralCache<Node>::carved(const Slot &slot)
+{
+    //只能容纳一个节点的span没有意义
+    return slot.size != 0 && slot.size * 2 <= _span_size;
+}
+
+template <typename Node>
+void CentralCache<Node>::collect(PAGE_SIZE_TYPE type, CentralCacheStats &stats)
+{
+    stats.system_bytes += _system_bytes.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < _len; i++)
+    {
+        std::size_t blocks = length(i);
+        if (blocks != 0)
+        {
+            stats.classes.push_back(SizeClassStats{type, i, _slots[i].size, blocks});
+            stats.cached_bytes += blocks * _slots[i].size;
+        }
+    }
+}
+
+#endif /* __CENTRAL_CACHE_HPP__ */
@@ -3,10 +3,31 @@
 
 constexpr const unsigned long long KB = 1024;
 constexpr const unsigned long long MB = 1048576;
-constexpr const unsigned long long SMALLS_MIN_IDX = 6;
-constexpr const unsigned long long SMALLS_LEN = 12;
+// 16B ~ 256B 增长为16B, 256B ~ 2048B 每个2的幂区间分为4个size class
+constexpr const unsigned long long SMALLS_LEN = 16 + 12;
 constexpr const unsigned long long NORMALS_LEN = 4096 + 1;
 constexpr const unsigned long long HUGES_LEN = 48;
+constexpr const unsigned long long SMALL_MAX_SIZE = 2 * KB;
+constexpr const unsigned long long NORMAL_MAX_SIZE = 16 * MB;
+constexpr const unsigned long long HUGE_MAX_SIZE = 64 * MB;
+// PageHeap与CentralCache之间每次移动的字节数, 以及节点数量的上下限
+constexpr const unsigned long long TRANSFER_BATCH_BYTES = 64 * KB;
+constexpr const unsigned long long TRANSFER_BATCH_MIN = 1;
+constexpr const unsigned long long TRANSFER_BATCH_MAX = 32;
+// SMALL size class一次从系统申请的span大小, 切分成多个block
+constexpr const unsigned long long SMALL_SPAN_SIZE = 64 * KB;
+// NORMAL size class一次从系统申请的span大小, 不超过一半的size class从span切分, 更大的单独申请
+constexpr const unsigned long long NORMAL_SPAN_SIZE = 1 * MB;
+// 释放到其他线程的block在本线程缓存的槽数, 必须是2的幂
+constexpr const unsigned long long REMOTE_BATCH_SLOTS = 64;
+// 按id查找PageHeap的两级表, 每个chunk的表项数量, 共HEAP_CHUNKS个chunk覆盖16位id
+constexpr const unsigned long long HEAP_CHUNK_SHIFT = 8;
+constexpr const unsigned long long HEAP_CHUNK_SIZE = 1ULL << HEAP_CHUNK_SHIFT;
+constexpr const unsigned long long HEAP_CHUNKS = 65536 / HEAP_CHUNK_SIZE;
+// 每个NUMA节点一组中心缓存, 支持的最大节点数量
+constexpr const unsigned long long MAX_NUMA_NODES = 8;
+// 大页大小, 不小于这个大小的block可以使用大页
+constexpr const unsigned long long HUGE_PAGE_SIZE = 2 * MB;
 
 enum class PAGE_SIZE_TYPE
 {
@@ -16,4 +37,15 @@ enum class PAGE_SIZE_TYPE
     UNMANAGE
 };
 
+// 不小于HUGE_PAGE_SIZE的内存从系统申请时使用的页
+enum class HUGE_PAGE_MODE
+{
+    // 普通4KB页
+    NONE,
+    // 按2MB对齐并使用MADV_HUGEPAGE, 由内核透明大页合并
+    TRANSPARENT,
+    // 大小为2MB整数倍时使用MAP_HUGETLB, 预留的大页不足时退化为TRANSPARENT
+    EXPLICIT
+};
+
 #endif // __CONSTANT_HPP__
\ No newline at end of file
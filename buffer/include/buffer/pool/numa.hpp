@@ -0,0 +1,30 @@
+#ifndef __NUMA_HPP__
+#define __NUMA_HPP__
+
+#include <cinttypes>
+
+/**
+ * @brief 系统的NUMA节点数量, 读取/sys/devices/system/node/online, 不支持NUMA时为1
+ *        结果限制在MAX_NUMA_NODES以内
+ *
+ * @return std::size_t 节点数量
+ */
+std::size_t numa_node_count();
+
+/**
+ * @brief 当前线程所在CPU的NUMA节点, 使用getcpu
+ *
+ * @return std::size_t 节点编号, 小于numa_node_count()
+ */
+std::size_t numa_current_node();
+
+/**
+ * @brief 将内存绑定到NUMA节点(MPOL_PREFERRED), 节点内存不足时仍可以使用其他节点, 只有一个节点时不做任何操作
+ *
+ * @param ptr 内存地址, 按页对齐
+ * @param size 内存大小
+ * @param node 节点编号
+ */
+void numa_bind(void *ptr, std::size_t size, std::size_t node);
+
+#endif /* __NUMA_HPP__ */
@@ -3,10 +3,19 @@
 
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <cinttypes>
+#include <mutex>
+#include <vector>
+#include <algorithm>
 
 #include "buffer/byte.hpp"
 #include "buffer/pool/constant.hpp"
+#include "buffer/pool/central_cache.hpp"
+#include "buffer/pool/page_map.hpp"
+#include "buffer/pool/numa.hpp"
+#include "buffer/pool/size_class.hpp"
+#include "buffer/pool/pool_stats.hpp"
 
 template<typename T>
 class PageHeap
@@ -18,35 +27,129 @@ private:
         union PageNode *next;
         T *data;
     };
+    typedef CentralCache<PageNode> Central;
+
+    //统计计数器, 只在所属线程修改(remote_frees除外), 其他线程可以随时读取
+    struct Counters
+    {
+        std::atomic<std::size_t> allocs{0};
+        std::atomic<std::size_t> frees{0};
+        //其他线程释放到"回收的空闲链表"的数量
+        std::atomic<std::size_t> remote_frees{0};
+        //从"回收的空闲链表"取回的数量
+        std::atomic<std::size_t> remote_drained{0};
+        std::atomic<std::size_t> central_fetches{0};
+        std::atomic<std::size_t> central_releases{0};
+        std::atomic<std::size_t> unmanage_allocs{0};
+        //缓存在本线程, 还没有放回其他线程的block数量
+        std::atomic<std::size_t> remote_pending{0};
+    };
+
+    //释放到同一个线程同一个size class的block, 凑满一个batch后一次CAS放入所属线程的"回收的空闲链表"
+    //只保存owner的id, 放回时才查找owner, 不会因为缓存的batch延长owner的生命周期
+    struct RemoteBatch
+    {
+        std::uint16_t owner_id = 0;
+        //block所在NUMA节点, owner不存在或者不在这个节点时返还给这个节点的中心缓存
+        std::size_t node = 0;
+        PAGE_SIZE_TYPE type = PAGE_SIZE_TYPE::UNMANAGE;
+        std::uint64_t index = 0;
+        PageNode *first = nullptr;
+        PageNode *last = nullptr;
+        std::size_t count = 0;
+    };
+
+    //按id查找PageHeap的表项, 读取不加锁
+    struct HeapSlot
+    {
+        std::atomic<PageHeap *> heap{nullptr};
+        //正在使用heap的线程数量, PageHeap析构时等待归零
+        std::atomic<std::size_t> refs{0};
+        //id已经分配, 由registry_mutex保护
+        bool used = false;
+    };
 
 private:
     //所属线程id
     std::thread::id _thread_id;
+    //在PageMap中标识所属PageHeap, 构造时分配, 0表示没有分配
+    std::uint16_t _id = 0;
+    //创建线程所在NUMA节点, 使用这个节点的中心缓存
+    std::size_t _node;
 
     //空闲链表
-    // 64B ~ 2048B, 增长为2的幂
+    // 16B ~ 2048B, 256B以下增长为16B, 以上每个2的幂区间分为4个
     PageNode **_smalls_free = new PageNode *[SMALLS_LEN];
     // 4KB ~ 16MB, 增长为4K
     PageNode **_normals_free = new PageNode *[NORMALS_LEN];
     //_huge > 16MB, 17MB ~ 64MB, 增长为1MB
     PageNode **_huges_free = new PageNode *[HUGES_LEN];
 
+    //空闲链表长度, 超过2个batch时将一个batch返还给中心缓存
+    std::atomic<std::size_t> *_smalls_len = new std::atomic<std::size_t>[SMALLS_LEN];
+    std::atomic<std::size_t> *_normals_len = new std::atomic<std::size_t>[NORMALS_LEN];
+    std::atomic<std::size_t> *_huges_len = new std::atomic<std::size_t>[HUGES_LEN];
+
     //回收的空闲链表: 释放的内存形成的空闲链表, 包括本线程释放和其他线程释放
-    // 64B ~ 2048B, 增长为2的幂
+    // 16B ~ 2048B, 256B以下增长为16B, 以上每个2的幂区间分为4个
     std::atomic<PageNode *> *_thread_smalls_free = new std::atomic<PageNode *>[SMALLS_LEN];
     // 4KB ~ 16MB, 增长为4K
     std::atomic<PageNode *> *_thread_normals_free = new std::atomic<PageNode *>[NORMALS_LEN];
     //_huge > 16MB, 17MB ~ 64MB, 增长为1MB
     std::atomic<PageNode *> *_thread_huges_free = new std::atomic<PageNode *>[HUGES_LEN];
 
+    //释放到其他线程的block, 按(所属线程, size class)散列
+    RemoteBatch *_remote_batches = new RemoteBatch[REMOTE_BATCH_SLOTS];
+
+    Counters _counters;
+
 private:
     //头节点插入
     static void insert(std::atomic<PageNode *> &head, PageNode *&node);
+    //头部插入first到last的链表, 只需要一次CAS
+    static void insert_range(std::atomic<PageNode *> &head, PageNode *first, PageNode *last);
     //初始化
-    static void init(PageNode **&head, std::size_t size);
-    static void destory(PageNode **&head, std::size_t size);
+    static void init(PageNode **&head, std::atomic<std::size_t> *&len, std::size_t size);
+    static void destory(PageNode **&head, std::atomic<std::size_t> *&len, std::size_t size, Central *central);
     static void init_atomic(std::atomic<PageNode *> *&head, std::size_t size);
-    static void destory_atomic(std::atomic<PageNode *> *&head, std::size_t size);
+    static void destory_atomic(std::atomic<PageNode *> *&head, std::size_t size, Central *central);
+    //将空闲链表头部的一个batch返还给中心缓存
+    static void release_batch(std::uint64_t index, PageNode **&head, std::atomic<std::size_t> *&len, Central *central);
+    //将以first开始的整个链表按batch返还给中心缓存, 返回链表长度
+    static std::size_t release_list(std::uint64_t index, PageNode *first, Central *central);
+    //只在所属线程修改的计数器, 不需要原子的读-改-写
+    static void relaxed_add(std::atomic<std::size_t> &counter, std::size_t n);
+    static void relaxed_sub(std::atomic<std::size_t> &counter, std::size_t n);
+    //统计一类空闲链表中的block
+    static void collect(PAGE_SIZE_TYPE type, std::atomic<std::size_t> *len, std::size_t size, Central *central, ThreadCacheStats &stats);
+
+    //所有存活的PageHeap按id保存在两级表中, 高8位选择chunk, 低8位为chunk内下标
+    //chunk在第一次使用时创建且不释放, 查找不需要加锁, registry_mutex只保护id的分配和回收
+    static std::mutex &registry_mutex();
+    static std::atomic<HeapSlot *> *heap_chunks();
+    //id所在的表项, chunk还没有创建时返回nullptr
+    static HeapSlot *heap_slot(std::uint16_t id);
+    //已经分配的最大id, 用于遍历所有PageHeap
+    static std::atomic<std::uint16_t> &max_id();
+    //按id查找存活的PageHeap并增加引用, 不存在时返回nullptr, 返回非空时必须调用release释放
+    static PageHeap *acquire(std::uint16_t id);
+    static void release(std::uint16_t id);
+    //分配id并发布到表中, 所有id都被占用时_id为0
+    void register_heap();
+    //从表中移除, 等待正在使用的线程离开, 然后回收id
+    void unregister_heap();
+
+    //所有PageHeap共享的中心缓存, 每个NUMA节点一组, 不释放以避免线程退出时中心缓存已经析构
+    static Central **create_centrals(std::size_t len, std::uint64_t (*index_to_size)(std::uint64_t), std::size_t span_size);
+    static Central *central_smalls(std::size_t node);
+    static Central *central_normals(std::size_t node);
+    static Central *central_huges(std::size_t node);
+    static Central *central(PAGE_SIZE_TYPE type, std::size_t node);
+
+    //将缓存的一个batch放回所属线程, 所属线程已经不存在时返还给中心缓存
+    void flush_remote(RemoteBatch &batch);
+    //其他线程将一个batch放入本线程的"回收的空闲链表"
+    void thread_free_range(PAGE_SIZE_TYPE type, std::uint64_t index, PageNode *first, PageNode *last, std::size_t n);
 
 public:
     PageHeap(const PageHeap&) = delete;
@@ -54,12 +157,20 @@ public:
     PageHeap();
     ~PageHeap();
 
+    /**
+     * @brief 创建PageHeap, 其他线程释放的内存可以通过PageMap中的id找到这个PageHeap
+     * @return std::shared_ptr<PageHeap> 新的PageHeap
+     */
+    static std::shared_ptr<PageHeap> create();
+
     //返回所属线程id
     std::thread::id thread_id();
+    //返回PageMap中使用的id
+    std::uint16_t id();
 
-    static inline void alloc(std::uint64_t index, Byte *&data, std::atomic<PageNode *> *&atomic_head, PageHeap<T>::PageNode **&head);
-    static inline void free(std::uint64_t index, Byte *data, PageHeap<T>::PageNode **&head);
-    static inline void free(std::uint64_t index, Byte *data, std::atomic<PageNode *> *&atomic_head);
+    static inline void alloc(PAGE_SIZE_TYPE type, std::uint16_t owner, std::size_t numa_node, std::uint64_t index, Byte *&data, std::atomic<PageNode *> *&atomic_head, PageHeap<T>::PageNode **&head, std::atomic<std::size_t> *&len, Central *central, Counters &counters);
+    static inline void free(std::uint64_t index, Byte *data, PageHeap<T>::PageNode **&head, std::atomic<std::size_t> *&len, Central *central, Counters &counters);
+    static inline void free(std::uint64_t index, Byte *data, std::atomic<PageNode *> *&atomic_head, Counters &counters);
 
     void alloc_small(std::uint64_t index, Byte *&data);
     void alloc_normal(std::uint64_t index, Byte *&data);
@@ -69,36 +180,75 @@ public:
     void free_small(std::uint64_t index, Byte *data);
     void free_normal(std::uint64_t index, Byte *data);
     void free_huge(std::uint64_t index, Byte *data);
+    //index为内存大小
     void free_unmanage(std::uint64_t index, Byte *data);
 
     void thread_free_small(std::uint64_t index, Byte *data);
     void thread_free_normal(std::uint64_t index, Byte *data);
     void thread_free_huge(std::uint64_t index, Byte *data);
     void thread_free_unmanage(std::uint64_t index, Byte *data);
+
+    /**
+     * @brief 在本线程释放owner线程申请的内存, block先缓存在本线程,
+     *        同一个(owner, size class)凑满一个batch后一次放回owner的"回收的空闲链表"
+     *        owner已经不存在时返还给中心缓存
+     * @param owner_id 内存申请线程的PageHeap的id
+     * @param numa_node 内存所在NUMA节点
+     * @param type size class类型
+     * @param index 内存在free_list的下标
+     * @param data 内存指针
+     */
+    void remote_free(std::uint16_t owner_id, std::size_t numa_node, PAGE_SIZE_TYPE type, std::uint64_t index, Byte *data);
+    //将缓存的所有block放回所属线程, 只能在所属线程调用
+    void flush_remote();
+    //将NORMAL和BIG的空闲链表返还给中心缓存, 只能在所属线程调用
+    void flush();
+    //将中心缓存中一直没有被使用的NORMAL和BIG内存返还给系统, 返回真正返还的字节数
+    static std::size_t release_memory(std::size_t bytes);
+
+    //本线程缓存的统计信息
+    ThreadCacheStats stats();
+    //所有存活的PageHeap以及中心缓存的统计信息
+    static PoolStats all_stats();
 };
 
 template<typename T>
-PageHeap<T>::PageHeap() : _thread_id(std::this_thread::get_id())
+PageHeap<T>::PageHeap() : _thread_id(std::this_thread::get_id()), _node(numa_current_node())
 {
-    init(_smalls_free, SMALLS_LEN);
-    init(_normals_free, NORMALS_LEN);
-    init(_huges_free, HUGES_LEN);
+    init(_smalls_free, _smalls_len, SMALLS_LEN);
+    init(_normals_free, _normals_len, NORMALS_LEN);
+    init(_huges_free, _huges_len, HUGES_LEN);
 
     init_atomic(_thread_smalls_free, SMALLS_LEN);
     init_atomic(_thread_normals_free, NORMALS_LEN);
     init_atomic(_thread_huges_free, HUGES_LEN);
+
+    register_heap();
 }
 
 template<typename T>
 PageHeap<T>::~PageHeap()
 {
-    destory(_smalls_free, SMALLS_LEN);
-    destory(_normals_free, NORMALS_LEN);
-    destory(_huges_free, HUGES_LEN);
+    //先从表中移除, 之后其他线程不会再放入"回收的空闲链表", 已经放入的在下面返还给中心缓存
+    unregister_heap();
+
+    flush_remote();
+    delete[] _remote_batches;
 
-    destory_atomic(_thread_smalls_free, SMALLS_LEN);
-    destory_atomic(_thread_normals_free, NORMALS_LEN);
-    destory_atomic(_thread_huges_free, HUGES_LEN);
+    //线程退出时, 缓存的内存返还给中心缓存供其他线程使用
+    destory(_smalls_free, _smalls_len, SMALLS_LEN, central_smalls(_node));
+    destory(_normals_free, _normals_len, NORMALS_LEN, central_normals(_node));
+    destory(_huges_free, _huges_len, HUGES_LEN, central_huges(_node));
+
+    destory_atomic(_thread_smalls_free, SMALLS_LEN, central_smalls(_node));
+    destory_atomic(_thread_normals_free, NORMALS_LEN, central_normals(_node));
+    destory_atomic(_thread_huges_free, HUGES_LEN, central_huges(_node));
+}
+
+template<typename T>
+std::shared_ptr<PageHeap<T>> PageHeap<T>::create()
+{
+    return std::make_shared<PageHeap>();
 }
 
 template<typename T>
@@ -108,28 +258,30 @@ std::thread::id PageHeap<T>::thread_id()
 }
 
 template<typename T>
-void PageHeap<T>::init(PageNode **&head, std::size_t size)
+std::uint16_t PageHeap<T>::id()
+{
+    return _id;
+}
+
+template<typename T>
+void PageHeap<T>::init(PageNode **&head, std::atomic<std::size_t> *&len, std::size_t size)
 {
     for (size_t i = 0; i < size; i++)
     {
         head[i] = nullptr;
+        len[i].store(0);
     }
 }
 
 template<typename T>
-void PageHeap<T>::destory(PageNode **&head, std::size_t size)
+void PageHeap<T>::destory(PageNode **&head, std::atomic<std::size_t> *&len, std::size_t size, Central *central)
 {
     for (size_t i = 0; i < size; i++)
     {
-        PageNode * node0 = head[i];
-        while (node0 != nullptr)
-        {
-            PageNode *node = node0->next;
-            delete[] node0;
-            node0 = node;
-        }
+        release_list(i, head[i], central);
     }
     delete[] head;
+    delete[] len;
 }
 
 template<typename T>
@@ -142,133 +294,561 @@ void PageHeap<T>::init_atomic(std::atomic<PageNode *> *&head, std::size_t size)
 }
 
 template<typename T>
-void PageHeap<T>::destory_atomic(std::atomic<PageNode *> *&head, std::size_t size)
+void PageHeap<T>::destory_atomic(std::atomic<PageNode *> *&head, std::size_t size, Central *central)
 {
     for (size_t i = 0; i < size; i++)
     {
-        auto node0 = head[i].load();
-        while (node0 != nullptr)
+        release_list(i, head[i].exchange(nullptr), central);
+    }
+    delete[] head;
+}
+
+template<typename T>
+void PageHeap<T>::release_batch(std::uint64_t index, PageNode **&head, std::atomic<std::size_t> *&len, Central *central)
+{
+    std::size_t batch = central->batch_size(index);
+    PageNode *first = head[index];
+    PageNode *last = first;
+    for (std::size_t i = 1; i < batch; i++)
+    {
+        last = last->next;
+    }
+    head[index] = last->next;
+    relaxed_sub(len[index], batch);
+    central->insert_range(index, first, last, batch);
+}
+
+template<typename T>
+std::size_t PageHeap<T>::release_list(std::uint64_t index, PageNode *first, Central *central)
+{
+    std::size_t batch = central->batch_size(index);
+    std::size_t total = 0;
+    while (first != nullptr)
+    {
+        std::size_t n = 1;
+        PageNode *last = first;
+        while (n < batch && last->next != nullptr)
         {
-            PageNode *node = node0->next;
-            delete[] node0;
-            node0 = node;
+            last = last->next;
+            n++;
         }
+        PageNode *next = last->next;
+        central->insert_range(index, first, last, n);
+        first = next;
+        total += n;
     }
-    delete[] head;
+    return total;
 }
 
 template<typename T>
-void PageHeap<T>::alloc(std::uint64_t index, Byte *&data, std::atomic<PageNode *> *&atomic_head, PageHeap<T>::PageNode **&head)
+void PageHeap<T>::relaxed_add(std::atomic<std::size_t> &counter, std::size_t n)
 {
-    PageNode *node = head[index];
-    if (node != nullptr)
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+template<typename T>
+void PageHeap<T>::relaxed_sub(std::atomic<std::size_t> &counter, std::size_t n)
+{
+    counter.store(counter.load(std::memory_order_relaxed) - n, std::memory_order_relaxed);
+}
+
+template<typename T>
+std::mutex &PageHeap<T>::registry_mutex()
+{
+    static std::mutex *mutex = new std::mutex();
+    return *mutex;
+}
+
+template<typename T>
+std::atomic<typename PageHeap<T>::HeapSlot *> *PageHeap<T>::heap_chunks()
+{
+    static std::atomic<HeapSlot *> *chunks = new std::atomic<HeapSlot *>[HEAP_CHUNKS]();
+    return chunks;
+}
+
+template<typename T>
+typename PageHeap<T>::HeapSlot *PageHeap<T>::heap_slot(std::uint16_t id)
+{
+    HeapSlot *chunk = heap_chunks()[id >> HEAP_CHUNK_SHIFT].load(std::memory_order_acquire);
+    return chunk == nullptr ? nullptr : &chunk[id & (HEAP_CHUNK_SIZE - 1)];
+}
+
+template<typename T>
+std::atomic<std::uint16_t> &PageHeap<T>::max_id()
+{
+    static std::atomic<std::uint16_t> *id = new std::atomic<std::uint16_t>(0);
+    return *id;
+}
+
+template<typename T>
+PageHeap<T> *PageHeap<T>::acquire(std::uint16_t id)
+{
+    HeapSlot *slot = id == 0 ? nullptr : heap_slot(id);
+    if (slot == nullptr)
     {
-        //空闲链表不为空
-        head[index] = node->next;
+        return nullptr;
     }
-    else
+    //先增加引用再读取heap, 与unregister_heap的先清空heap再等待引用归零配对(都是seq_cst)
+    //读到非空时析构线程一定能看到这次引用
+    slot->refs.fetch_add(1);
+    PageHeap *heap = slot->heap.load();
+    if (heap == nullptr)
+    {
+        slot->refs.fetch_sub(1);
+    }
+    return heap;
+}
+
+template<typename T>
+void PageHeap<T>::release(std::uint16_t id)
+{
+    heap_slot(id)->refs.fetch_sub(1);
+}
+
+template<typename T>
+void PageHeap<T>::register_heap()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    //复用已经析构的PageHeap的id, 0保留表示没有分配
+    for (std::size_t id = 1; id < HEAP_CHUNKS * HEAP_CHUNK_SIZE; id++)
+    {
+        std::atomic<HeapSlot *> &chunk = heap_chunks()[id >> HEAP_CHUNK_SHIFT];
+        if (chunk.load(std::memory_order_relaxed) == nullptr)
+        {
+            chunk.store(new HeapSlot[HEAP_CHUNK_SIZE], std::memory_order_release);
+        }
+        HeapSlot *slot = heap_slot((std::uint16_t)id);
+        if (!slot->used)
+        {
+            slot->used = true;
+            _id = (std::uint16_t)id;
+            if (_id > max_id().load(std::memory_order_relaxed))
+            {
+                max_id().store(_id);
+            }
+            slot->heap.store(this);
+            return;
+        }
+    }
+}
+
+template<typename T>
+void PageHeap<T>::unregister_heap()
+{
+    if (_id == 0)
+    {
+        return;
+    }
+    HeapSlot *slot = heap_slot(_id);
+    slot->heap.store(nullptr);
+    //其他线程持有引用的时间只有一次CAS或者一次统计, 自旋等待即可
+    while (slot->refs.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    slot->used = false;
+}
+
+template<typename T>
+typename PageHeap<T>::Central **PageHeap<T>::create_centrals(std::size_t len, std::uint64_t (*index_to_size)(std::uint64_t), std::size_t span_size)
+{
+    Central **centrals = new Central *[numa_node_count()];
+    for (std::size_t i = 0; i < numa_node_count(); i++)
+    {
+        centrals[i] = new Central(len, index_to_size, span_size, i);
+    }
+    return centrals;
+}
+
+template<typename T>
+typename PageHeap<T>::Central *PageHeap<T>::central_smalls(std::size_t node)
+{
+    //SMALL size class从span切分, 一次系统调用得到多个block
+    static Central **centrals = create_centrals(SMALLS_LEN, [](std::uint64_t index) { return SizeClass().small_index_to_size(index); }, SMALL_SPAN_SIZE);
+    return centrals[node];
+}
+
+template<typename T>
+typename PageHeap<T>::Central *PageHeap<T>::central_normals(std::size_t node)
+{
+    //不超过512KB的NORMAL size class从span切分, 避免每个block一次mmap
+    static Central **centrals = create_centrals(NORMALS_LEN, [](std::uint64_t index) { return SizeClass().normal_index_to_size(index); }, NORMAL_SPAN_SIZE);
+    return centrals[node];
+}
+
+template<typename T>
+typename PageHeap<T>::Central *PageHeap<T>::central_huges(std::size_t node)
+{
+    static Central **centrals = create_centrals(HUGES_LEN, [](std::uint64_t index) { return SizeClass().huge_index_to_size(index); }, 0);
+    return centrals[node];
+}
+
+template<typename T>
+typename PageHeap<T>::Central *PageHeap<T>::central(PAGE_SIZE_TYPE type, std::size_t node)
+{
+    switch (type)
+    {
+    case PAGE_SIZE_TYPE::SMALL:
+        return central_smalls(node);
+    case PAGE_SIZE_TYPE::NORMAL:
+        return central_normals(node);
+    default:
+        return central_huges(node);
+    }
+}
+
+template<typename T>
+void PageHeap<T>::alloc(PAGE_SIZE_TYPE type, std::uint16_t owner, std::size_t numa_node, std::uint64_t index, Byte *&data, std::atomic<PageNode *> *&atomic_head, PageHeap<T>::PageNode **&head, std::atomic<std::size_t> *&len, Central *central, Counters &counters)
+{
+    PageNode *node = head[index];
+    if (node == nullptr)
     {
         //空闲链表为空
-        //将"回收的空闲链表" 与 "空闲链表" 互换, 并再次尝试从"空闲链表"分配
-        //若再次分配失败, 则从系统申请
-        PageNode *old_head;
-        do
+        //将"回收的空闲链表"取出作为"空闲链表", 超过2个batch的部分返还给中心缓存
+        //"回收的空闲链表"也为空时, 从中心缓存取一个batch, SMALL size class的中心缓存为空时会切分新的span
+        //中心缓存从系统申请内存失败时, 返回nullptr
+        node = atomic_head[index].exchange(nullptr);
+        if (node != nullptr)
         {
-            old_head = atomic_head->load();
-        } while (!atomic_head->compare_exchange_weak(old_head, head[index]));
-        node = head[index];
+            std::size_t max_len = 2 * central->batch_size(index);
+            std::size_t n = 1;
+            PageNode *last = node;
+            while (n < max_len && last->next != nullptr)
+            {
+                last = last->next;
+                n++;
+            }
+            std::size_t released = release_list(index, last->next, central);
+            last->next = nullptr;
+            len[index].store(n, std::memory_order_relaxed);
+            relaxed_add(counters.remote_drained, n + released);
+            relaxed_add(counters.central_releases, released);
+        }
+        else
+        {
+            std::size_t n = central->remove_range(index, node, central->batch_size(index));
+            len[index].store(n, std::memory_order_relaxed);
+            relaxed_add(counters.central_fetches, n);
+
+            //从中心缓存取出的NORMAL和BIG block归属于本线程, 释放时按PageMap找回
+            //SMALL block所在span被切分成多个block, 同一页的block可能在不同线程, owner和节点为0, 同一span的记录都相同
+            //NORMAL和BIG的中心缓存只保存本节点的内存, 本线程的节点就是block的节点
+            for (PageNode *cur = node; cur != nullptr; cur = cur->next)
+            {
+                PageMap::instance()->set(cur, PageMap::Entry{type, index, owner, (std::uint8_t)numa_node});
+            }
+        }
+    }
+
+    if (node != nullptr)
+    {
+        head[index] = node->next;
+        relaxed_sub(len[index], 1);
+        relaxed_add(counters.allocs, 1);
     }
     // data的结果可能为空
-    // data = (node == nullptr) ? nullptr : (Byte *)node;
     data = (Byte *)node;
 }
 
 template<typename T>
-void PageHeap<T>::free(std::uint64_t index, Byte *data, std::atomic<PageNode *> *&atomic_head)
+void PageHeap<T>::free(std::uint64_t index, Byte *data, std::atomic<PageNode *> *&atomic_head, Counters &counters)
 {
     auto node = (PageNode *)data;
     node->next = nullptr;
     insert(atomic_head[index], node);
+    counters.remote_frees.fetch_add(1, std::memory_order_relaxed);
 }
 
 template<typename T>
-void PageHeap<T>::free(std::uint64_t index, Byte *data, PageHeap<T>::PageNode **&head)
+void PageHeap<T>::free(std::uint64_t index, Byte *data, PageHeap<T>::PageNode **&head, std::atomic<std::size_t> *&len, Central *central, Counters &counters)
 {
     PageNode *node = (PageNode *)data;
     node->next = head[index];
     head[index] = node;
+    relaxed_add(counters.frees, 1);
+    relaxed_add(len[index], 1);
+    if (len[index].load(std::memory_order_relaxed) > 2 * central->batch_size(index))
+    {
+        release_batch(index, head, len, central);
+        relaxed_add(counters.central_releases, central->batch_size(index));
+    }
 }
 
 template<typename T>
 void PageHeap<T>::alloc_small(std::uint64_t index, Byte *&data)
 {
-    alloc(index, data, _thread_smalls_free, _smalls_free);
+    alloc(PAGE_SIZE_TYPE::SMALL, 0, 0, index, data, _thread_smalls_free, _smalls_free, _smalls_len, central_smalls(_node), _counters);
 }
 
 template<typename T>
 void PageHeap<T>::alloc_normal(std::uint64_t index, Byte *&data)
 {
-    alloc(index, data, _thread_normals_free, _normals_free);
+    alloc(PAGE_SIZE_TYPE::NORMAL, _id, _node, index, data, _thread_normals_free, _normals_free, _normals_len, central_normals(_node), _counters);
 }
 
 template<typename T>
 void PageHeap<T>::alloc_huge(std::uint64_t index, Byte *&data)
 {
-    alloc(index, data, _thread_huges_free, _huges_free);
+    alloc(PAGE_SIZE_TYPE::BIG, _id, _node, index, data, _thread_huges_free, _huges_free, _huges_len, central_huges(_node), _counters);
 }
 
 template<typename T>
 void PageHeap<T>::alloc_unmanage(std::uint64_t size, Byte *&data) 
 {
-    data = new Byte[size];
+    //直接从系统申请, 大小记录在PageMap中
+    data = (Byte *)system_alloc(size, _node);
+    if (data != nullptr)
+    {
+        PageMap::instance()->set(data, PageMap::Entry{PAGE_SIZE_TYPE::UNMANAGE, size, _id, (std::uint8_t)_node});
+        relaxed_add(_counters.unmanage_allocs, 1);
+    }
 }
 
 template<typename T>
 void PageHeap<T>::free_small(std::uint64_t index, Byte *data)
 {
-    free(index, data, _smalls_free);
+    free(index, data, _smalls_free, _smalls_len, central_smalls(_node), _counters);
 }
 
 template<typename T>
 void PageHeap<T>::free_normal(std::uint64_t index, Byte *data)
 {
-    free(index, data, _normals_free);
+    free(index, data, _normals_free, _normals_len, central_normals(_node), _counters);
 }
 
 template<typename T>
 void PageHeap<T>::free_huge(std::uint64_t index, Byte *data)
 {
-    free(index, data, _huges_free);
+    free(index, data, _huges_free, _huges_len, central_huges(_node), _counters);
 }
 
 template<typename T>
 void PageHeap<T>::free_unmanage(std::uint64_t index, Byte *data) 
 {
-    delete[] data;
+    PageMap::instance()->clear(data);
+    system_free(data, index);
 }
 
 template<typename T>
 void PageHeap<T>::thread_free_small(std::uint64_t index, Byte *data)
 {
-    free(index, data, _thread_smalls_free);
+    free(index, data, _thread_smalls_free, _counters);
 }
 
 template<typename T>
 void PageHeap<T>::thread_free_normal(std::uint64_t index, Byte *data)
 {
-    free(index, data, _thread_normals_free);
+    free(index, data, _thread_normals_free, _counters);
 }
 
 template<typename T>
 void PageHeap<T>::thread_free_huge(std::uint64_t index, Byte *data)
 {
-    free(index, data, _thread_huges_free);
+    free(index, data, _thread_huges_free, _counters);
 }
 
 template<typename T>
 void PageHeap<T>::thread_free_unmanage(std::uint64_t index, Byte *data) 
 {
-    delete[] data;
+    free_unmanage(index, data);
+}
+
+template<typename T>
+void PageHeap<T>::remote_free(std::uint16_t owner_id, std::size_t numa_node, PAGE_SIZE_TYPE type, std::uint64_t index, Byte *data)
+{
+    if (type == PAGE_SIZE_TYPE::UNMANAGE)
+    {
+        free_unmanage(index, data);
+        return;
+    }
+
+    std::size_t slot = ((std::size_t)owner_id ^ (index << 2) ^ (std::size_t)type) & (REMOTE_BATCH_SLOTS - 1);
+    RemoteBatch &batch = _remote_batches[slot];
+    if (batch.count != 0 && (batch.owner_id != owner_id || batch.node != numa_node || batch.type != type || batch.index != index))
+    {
+        //散列冲突, 先放回之前的batch
+        flush_remote(batch);
+    }
+
+    PageNode *node = (PageNode *)data;
+    if (batch.count == 0)
+    {
+        batch.owner_id = owner_id;
+        batch.node = numa_node;
+        batch.type = type;
+        batch.index = index;
+        batch.last = node;
+        node->next = nullptr;
+    }
+    else
+    {
+        node->next = batch.first;
+    }
+    batch.first = node;
+    batch.count++;
+    relaxed_add(_counters.remote_pending, 1);
+
+    if (batch.count >= central(type, _node)->batch_size(index))
+    {
+        flush_remote(batch);
+    }
+}
+
+template<typename T>
+void PageHeap<T>::flush_remote()
+{
+    for (std::size_t i = 0; i < REMOTE_BATCH_SLOTS; i++)
+    {
+        if (_remote_batches[i].count != 0)
+        {
+            flush_remote(_remote_batches[i]);
+        }
+    }
+}
+
+template<typename T>
+void PageHeap<T>::flush_remote(RemoteBatch &batch)
+{
+    //每个batch只查找一次owner, 不加锁
+    //owner已经退出时返还给block所在节点的中心缓存, 而不是本线程节点的中心缓存
+    //id被其他节点的新线程复用时同样返还给block所在节点, 保证中心缓存只保存本节点的内存
+    PageHeap *owner = acquire(batch.owner_id);
+    if (owner != nullptr && owner->_node == batch.node)
+    {
+        owner->thread_free_range(batch.type, batch.index, batch.first, batch.last, batch.count);
+    }
+    else
+    {
+        central(batch.type, batch.node)->insert_range(batch.index, batch.first, batch.last, batch.count);
+        relaxed_add(_counters.central_releases, batch.count);
+    }
+    if (owner != nullptr)
+    {
+        release(batch.owner_id);
+    }
+    relaxed_sub(_counters.remote_pending, batch.count);
+    batch.owner_id = 0;
+    batch.first = nullptr;
+    batch.last = nullptr;
+    batch.count = 0;
+}
+
+template<typename T>
+void PageHeap<T>::thread_free_range(PAGE_SIZE_TYPE type, std::uint64_t index, PageNode *first, PageNode *last, std::size_t n)
+{
+    switch (type)
+    {
+    case PAGE_SIZE_TYPE::SMALL:
+        insert_range(_thread_smalls_free[index], first, last);
+        break;
+    case PAGE_SIZE_TYPE::NORMAL:
+        insert_range(_thread_normals_free[index], first, last);
+        break;
+    default:
+        insert_range(_thread_huges_free[index], first, last);
+        break;
+    }
+    _counters.remote_frees.fetch_add(n, std::memory_order_relaxed);
+}
+
+template<typename T>
+void PageHeap<T>::flush()
+{
+    flush_remote();
+    for (std::size_t i = 0; i < NORMALS_LEN; i++)
+    {
+        std::size_t released = release_list(i, _normals_free[i], central_normals(_node));
+        std::size_t drained = release_list(i, _thread_normals_free[i].exchange(nullptr), central_normals(_node));
+        _normals_free[i] = nullptr;
+        _normals_len[i].store(0, std::memory_order_relaxed);
+        relaxed_add(_counters.remote_drained, drained);
+        relaxed_add(_counters.central_releases, released + drained);
+    }
+    for (std::size_t i = 0; i < HUGES_LEN; i++)
+    {
+        std::size_t released = release_list(i, _huges_free[i], central_huges(_node));
+        std::size_t drained = release_list(i, _thread_huges_free[i].exchange(nullptr), central_huges(_node));
+        _huges_free[i] = nullptr;
+        _huges_len[i].store(0, std::memory_order_relaxed);
+        relaxed_add(_counters.remote_drained, drained);
+        relaxed_add(_counters.central_releases, released + drained);
+    }
+}
+
+template<typename T>
+std::size_t PageHeap<T>::release_memory(std::size_t bytes)
+{
+    std::size_t released = 0;
+    for (std::size_t node = 0; node < numa_node_count() && released < bytes; node++)
+    {
+        released += central_huges(node)->scavenge(bytes - released);
+    }
+    for (std::size_t node = 0; node < numa_node_count() && released < bytes; node++)
+    {
+        released += central_normals(node)->scavenge(bytes - released);
+    }
+    return released;
+}
+
+template<typename T>
+void PageHeap<T>::collect(PAGE_SIZE_TYPE type, std::atomic<std::size_t> *len, std::size_t size, Central *central, ThreadCacheStats &stats)
+{
+    for (std::size_t i = 0; i < size; i++)
+    {
+        std::size_t blocks = len[i].load(std::memory_order_relaxed);
+        if (blocks != 0)
+        {
+            stats.classes.push_back(SizeClassStats{type, i, central->size(i), blocks});
+            stats.cached_bytes += blocks * central->size(i);
+        }
+    }
+}
+
+template<typename T>
+ThreadCacheStats PageHeap<T>::stats()
+{
+    ThreadCacheStats stats;
+    stats.thread_id = _thread_id;
+    stats.node = _node;
+    stats.allocs = _counters.allocs.load(std::memory_order_relaxed);
+    stats.frees = _counters.frees.load(std::memory_order_relaxed);
+    stats.remote_frees = _counters.remote_frees.load(std::memory_order_relaxed);
+    std::size_t drained = _counters.remote_drained.load(std::memory_order_relaxed);
+    stats.remote_depth = stats.remote_frees > drained ? stats.remote_frees - drained : 0;
+    stats.central_fetches = _counters.central_fetches.load(std::memory_order_relaxed);
+    stats.central_releases = _counters.central_releases.load(std::memory_order_relaxed);
+    stats.unmanage_allocs = _counters.unmanage_allocs.load(std::memory_order_relaxed);
+    stats.remote_pending = _counters.remote_pending.load(std::memory_order_relaxed);
+    collect(PAGE_SIZE_TYPE::SMALL, _smalls_len, SMALLS_LEN, central_smalls(_node), stats);
+    collect(PAGE_SIZE_TYPE::NORMAL, _normals_len, NORMALS_LEN, central_normals(_node), stats);
+    collect(PAGE_SIZE_TYPE::BIG, _huges_len, HUGES_LEN, central_huges(_node), stats);
+    return stats;
+}
+
+template<typename T>
+PoolStats PageHeap<T>::all_stats()
+{
+    PoolStats stats;
+    //持有引用时PageHeap不会析构
+    std::uint16_t last = max_id().load();
+    for (std::uint16_t id = 1; id != 0 && id <= last; id++)
+    {
+        PageHeap *heap = acquire(id);
+        if (heap != nullptr)
+        {
+            stats.threads.push_back(heap->stats());
+            release(id);
+        }
+    }
+    //所有NUMA节点的中心缓存累加在一起
+    for (std::size_t node = 0; node < numa_node_count(); node++)
+    {
+        central_smalls(node)->collect(PAGE_SIZE_TYPE::SMALL, stats.central);
+        central_normals(node)->collect(PAGE_SIZE_TYPE::NORMAL, stats.central);
+        central_huges(node)->collect(PAGE_SIZE_TYPE::BIG, stats.central);
+    }
+    return stats;
 }
 
 template<typename T>
@@ -280,4 +860,13 @@ void PageHeap<T>::insert(std::atomic<PageNode *> &head, PageNode *&node)
     } while (!head.compare_exchange_weak(node->next, node));
 }
 
+template<typename T>
+void PageHeap<T>::insert_range(std::atomic<PageNode *> &head, PageNode *first, PageNode *last)
+{
+    last->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(last->next, first))
+    {
+    }
+}
+
 #endif // __PAGE_HEAP_HPP__
\ No newline at end of file
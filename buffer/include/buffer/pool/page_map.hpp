@@ -0,0 +1,89 @@
+#ifndef __PAGE_MAP_HPP__
+#define __PAGE_MAP_HPP__
+
+#include <atomic>
+#include <cinttypes>
+
+#include "buffer/pool/constant.hpp"
+
+/**
+ * @brief 内存地址到所属PageHeap和size class的映射, 三层基数树, 按4KB页索引
+ *        NORMAL, BIG和UNMANAGE的block独占所在页, 首地址所在页记录block的size class以及所属PageHeap的id
+ *        SMALL block从同一size class的span切分, 一页有多个block, 只记录size class, 不记录所属PageHeap
+ *        释放时不需要传入大小
+ *        只支持48位用户态地址, 树节点在第一次写入时创建且不释放
+ */
+class PageMap
+{
+public:
+    struct Entry
+    {
+        PAGE_SIZE_TYPE type;
+        // SMALL, NORMAL, BIG为free_list下标, UNMANAGE为内存大小
+        std::uint64_t index;
+        //所属PageHeap的id, 0表示不属于任何PageHeap, SMALL block总是0
+        std::uint16_t owner;
+        //内存所在NUMA节点, 所属PageHeap不存在时按节点返还中心缓存, SMALL block总是0
+        std::uint8_t node;
+    };
+
+private:
+    static constexpr const unsigned PAGE_SHIFT = 12;
+    static constexpr const unsigned LEVEL_BITS = 12;
+    static constexpr const std::size_t LEVEL_LEN = 1 << LEVEL_BITS;
+
+    struct Leaf
+    {
+        std::atomic<std::uint64_t> values[LEVEL_LEN];
+    };
+    struct Node
+    {
+        std::atomic<Leaf *> leaves[LEVEL_LEN];
+    };
+
+    std::atomic<Node *> _root[LEVEL_LEN];
+
+private:
+    PageMap();
+
+    /**
+     * @brief 地址所在页的记录
+     *
+     * @param ptr 内存地址
+     * @param create 树节点不存在时是否创建
+     * @return std::atomic<std::uint64_t>* 页记录, 地址超出范围或节点不存在时返回nullptr
+     */
+    std::atomic<std::uint64_t> *value(const void *ptr, bool create);
+
+public:
+    PageMap(const PageMap &) = delete;
+    PageMap &operator=(const PageMap &) = delete;
+
+    //所有PageHeap共享的映射, 不释放以避免线程退出时已经析构
+    static PageMap *instance();
+
+    /**
+     * @brief 记录block首地址所在页
+     *
+     * @param ptr block首地址
+     * @param entry block的size class, 所属PageHeap以及NUMA节点, SMALL block的owner和node为0
+     */
+    void set(const void *ptr, const Entry &entry);
+    /**
+     * @brief 查找block首地址所在页
+     *
+     * @param ptr block首地址
+     * @param entry 查找结果
+     * @return true 找到记录
+     * @return false 地址没有记录, 不是内存池申请的内存
+     */
+    bool get(const void *ptr, Entry &entry);
+    /**
+     * @brief 删除block首地址所在页的记录, 内存返还给系统之前调用
+     *
+     * @param ptr block首地址
+     */
+    void clear(const void *ptr);
+};
+
+#endif /* __PAGE_MAP_HPP__ */
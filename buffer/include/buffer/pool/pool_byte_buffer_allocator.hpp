@@ -2,17 +2,20 @@
 #define __POOL_BYTE_BUFFER_ALLOCATOR_HPP__
 
 #include <memory>
+#include <limits>
+#include <new>
 
 #include "buffer/pool/thread_page_heap.hpp"
 #include "buffer/pool/page_heap.hpp"
+#include "buffer/pool/page_map.hpp"
 #include "buffer/pool/size_class.hpp"
+#include "buffer/pool/pool_stats.hpp"
 
 template <typename T>
 class PoolByteBufferAllocator
 {
 private:
     static SizeClass *_size_class;
-    std::weak_ptr<PageHeap<T>> _page_heap_wptr = get_thread_local_page_heap();
 
 public:
     typedef T value_type;
@@ -24,7 +27,23 @@ public:
     ~PoolByteBufferAllocator();
 
     T *allocate(std::size_t n);
+    /**
+     * @brief 返还内存, 大小和所属线程通过PageMap查找, n只为兼容allocator接口
+     * @param p 内存指针
+     * @param n 内存大小
+     */
     void deallocate(T *p, std::size_t n);
+    /**
+     * @brief 返还内存, 大小和所属线程通过PageMap查找
+     * @param p 内存指针
+     */
+    void deallocate(T *p);
+    /**
+     * @brief 申请n个元素时真正得到的容量, 即n所在size class的大小
+     * @param n 元素个数
+     * @return std::size_t 容量
+     */
+    std::size_t good_size(std::size_t n);
 
     /**
      * @brief 申请一块新的size大小的内存, 在缓存为空时使用
@@ -104,6 +123,32 @@ public:
      */
     void thread_free_unmanage(std::uint64_t index, T *data);
 
+    /**
+     * @brief 将空闲的NORMAL、BIG内存返还给系统, 本线程缓存的内存先返还给中心缓存,
+     *        中心缓存中自上次调用以来一直没有被使用的内存返还给系统, 需要周期性调用
+     * @param bytes 最多返还的字节数
+     * @return std::size_t 真正返还的字节数
+     */
+    std::size_t release_memory(std::size_t bytes = std::numeric_limits<std::size_t>::max());
+
+    /**
+     * @brief 设置NORMAL、BIG以及超过64MB的内存从系统申请时使用的页, 只影响不小于2MB的block
+     *        已经缓存的内存不受影响, 可以先调用release_memory
+     * @param mode 大页模式
+     */
+    static void set_huge_page_mode(HUGE_PAGE_MODE mode);
+
+    /**
+     * @brief 所有线程缓存以及中心缓存的统计信息快照
+     * @return PoolStats 统计信息
+     */
+    PoolStats stats();
+    /**
+     * @brief 将统计信息快照转换成可读的string
+     * @return std::string 统计信息
+     */
+    std::string dump_stats();
+
     SizeClass *size_class();
 
     std::shared_ptr<PageHeap<T>> get_thread_local_page_heap();
@@ -133,7 +178,8 @@ T *PoolByteBufferAllocator<T>::allocate(std::size_t n)
     auto free_idx = si.free_list_index;
     auto cap = si.cap;
 
-    auto ph = _page_heap_wptr.lock();
+    //总是从当前线程的PageHeap申请, allocator可以在多个线程间传递
+    auto ph = get_thread_local_page_heap();
     T *bytes_ptr = nullptr;
 
     switch (page_type)
@@ -161,8 +207,8 @@ T *PoolByteBufferAllocator<T>::allocate(std::size_t n)
     }
     if (bytes_ptr == nullptr)
     {
-        auto ph = _page_heap_wptr.lock();
-        ph->alloc_unmanage(cap, bytes_ptr);
+        //从系统申请内存失败
+        throw std::bad_alloc();
     }
 
     return bytes_ptr;
@@ -171,77 +217,65 @@ T *PoolByteBufferAllocator<T>::allocate(std::size_t n)
 template <typename T>
 void PoolByteBufferAllocator<T>::deallocate(T *p, std::size_t n)
 {
-    auto si = _size_class->size_info(n);
-    auto page_type = si.size_type;
-    auto free_idx = si.free_list_index;
-    auto ph = _page_heap_wptr.lock();
+    deallocate(p);
+}
+
+template <typename T>
+void PoolByteBufferAllocator<T>::deallocate(T *p)
+{
+    PageMap::Entry entry;
+    if (p == nullptr || !PageMap::instance()->get(p, entry))
+    {
+        //不是内存池申请的内存
+        return;
+    }
+    auto ph = get_thread_local_page_heap();
 
-    if (std::this_thread::get_id() == ph->thread_id())
+    if (entry.type == PAGE_SIZE_TYPE::UNMANAGE)
+    {
+        ph->free_unmanage(entry.index, p);
+    }
+    else if (entry.type == PAGE_SIZE_TYPE::SMALL)
+    {
+        //SMALL block没有所属线程, 放回当前线程的free_list, 超过2个batch时返还给中心缓存
+        ph->free_small(entry.index, p);
+    }
+    else if (entry.owner == ph->id())
     {
         //"当前线程"为"内存申请线程"
         //放回free_list
-        switch (page_type)
-        {
-        case PAGE_SIZE_TYPE::SMALL:
+        switch (entry.type)
         {
-            ph->free_small(free_idx, p);
-            break;
-        }
         case PAGE_SIZE_TYPE::NORMAL:
         {
-            ph->free_normal(free_idx, p);
-            break;
-        }
-        case PAGE_SIZE_TYPE::BIG:
-        {
-            ph->free_huge(free_idx, p);
+            ph->free_normal(entry.index, p);
             break;
         }
         default:
         {
-            ph->free_unmanage(0, p);
+            ph->free_huge(entry.index, p);
             break;
         }
         }
     }
     else
     {
-        if (ph == nullptr)
-        {
-            //"当前线程"不为"内存申请线程", "内存申请线程"不存在
-            //将内存放回当前线程
-            ph = get_thread_local_page_heap();
-        }
-        switch (page_type)
-        {
-        case PAGE_SIZE_TYPE::SMALL:
-        {
-            ph->thread_free_small(free_idx, p);
-            break;
-        }
-        case PAGE_SIZE_TYPE::NORMAL:
-        {
-            ph->thread_free_normal(free_idx, p);
-            break;
-        }
-        case PAGE_SIZE_TYPE::BIG:
-        {
-            ph->thread_free_huge(free_idx, p);
-            break;
-        }
-        default:
-        {
-            ph->thread_free_unmanage(0, p);
-            break;
-        }
-        }
+        //"当前线程"不为"内存申请线程"
+        //先缓存在当前线程, 凑满一个batch后一次放回"内存申请线程", "内存申请线程"不存在时返还给中心缓存
+        ph->remote_free(entry.owner, entry.node, entry.type, entry.index, p);
     }
 }
 
+template <typename T>
+std::size_t PoolByteBufferAllocator<T>::good_size(std::size_t n)
+{
+    return _size_class->size_info(n).cap;
+}
+
 template <typename T>
 void PoolByteBufferAllocator<T>::alloc_unmanage(std::uint64_t size, T *&data)
 {
-    data = new T[size];
+    get_thread_local_page_heap()->alloc_unmanage(size, data);
 }
 
 template <typename T>
@@ -283,7 +317,7 @@ void PoolByteBufferAllocator<T>::free_huge(std::uint64_t index, T *data)
 template <typename T>
 void PoolByteBufferAllocator<T>::free_unmanage(std::uint64_t size, T *data)
 {
-    delete[] data;
+    get_thread_local_page_heap()->free_unmanage(size, data);
 }
 
 template <typename T>
@@ -307,7 +341,32 @@ void PoolByteBufferAllocator<T>::thread_free_huge(std::uint64_t index, T *data)
 template <typename T>
 void PoolByteBufferAllocator<T>::thread_free_unmanage(std::uint64_t index, T *data)
 {
-    delete[] data;
+    get_thread_local_page_heap()->thread_free_unmanage(index, data);
+}
+
+template <typename T>
+std::size_t PoolByteBufferAllocator<T>::release_memory(std::size_t bytes)
+{
+    get_thread_local_page_heap()->flush();
+    return PageHeap<T>::release_memory(bytes);
+}
+
+template <typename T>
+void PoolByteBufferAllocator<T>::set_huge_page_mode(HUGE_PAGE_MODE mode)
+{
+    ::set_huge_page_mode(mode);
+}
+
+template <typename T>
+PoolStats PoolByteBufferAllocator<T>::stats()
+{
+    return PageHeap<T>::all_stats();
+}
+
+template <typename T>
+std::string PoolByteBufferAllocator<T>::dump_stats()
+{
+    return stats().to_str();
 }
 
 template <typename T>
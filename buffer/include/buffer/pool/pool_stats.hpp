@@ -0,0 +1,69 @@
+#ifndef __POOL_STATS_HPP__
+#define __POOL_STATS_HPP__
+
+#include <thread>
+#include <string>
+#include <vector>
+#include <cinttypes>
+
+#include "buffer/pool/constant.hpp"
+
+//一个size class缓存的block
+struct SizeClassStats
+{
+    PAGE_SIZE_TYPE type;
+    std::uint64_t index;
+    std::uint64_t size;
+    std::uint64_t blocks;
+};
+
+//一个线程PageHeap的统计信息
+struct ThreadCacheStats
+{
+    std::thread::id thread_id;
+    //PageHeap使用的中心缓存所在NUMA节点
+    std::uint64_t node = 0;
+    std::uint64_t allocs = 0;
+    std::uint64_t frees = 0;
+    //其他线程释放到本线程的block数量
+    std::uint64_t remote_frees = 0;
+    //"回收的空闲链表"中还没有取回的block数量
+    std::uint64_t remote_depth = 0;
+    //本线程释放, 还没有放回其他线程的block数量
+    std::uint64_t remote_pending = 0;
+    //从中心缓存取得和返还给中心缓存的block数量
+    std::uint64_t central_fetches = 0;
+    std::uint64_t central_releases = 0;
+    //超过64MB, 直接从系统申请的次数
+    std::uint64_t unmanage_allocs = 0;
+    //空闲链表缓存的字节数
+    std::uint64_t cached_bytes = 0;
+    //不为空的size class
+    std::vector<SizeClassStats> classes;
+};
+
+//中心缓存的统计信息
+struct CentralCacheStats
+{
+    //从系统申请且还没有返还的字节数
+    std::uint64_t system_bytes = 0;
+    //中心缓存的字节数
+    std::uint64_t cached_bytes = 0;
+    //不为空的size class
+    std::vector<SizeClassStats> classes;
+};
+
+struct PoolStats
+{
+    std::vector<ThreadCacheStats> threads;
+    CentralCacheStats central;
+
+    /**
+     * @brief 将统计信息转换成可读的string
+     *
+     * @return std::string 统计信息
+     */
+    std::string to_str() const;
+};
+
+#endif /* __POOL_STATS_HPP__ */
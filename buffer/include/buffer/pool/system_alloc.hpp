@@ -0,0 +1,50 @@
+#ifndef __SYSTEM_ALLOC_HPP__
+#define __SYSTEM_ALLOC_HPP__
+
+#include <cinttypes>
+
+#include "buffer/pool/constant.hpp"
+
+/**
+ * @brief 使用mmap从系统申请内存, 地址按页对齐
+ *
+ * @param size 内存大小
+ * @return void* 内存地址, 失败时返回nullptr
+ */
+void *system_alloc(std::size_t size);
+
+/**
+ * @brief 使用mmap从系统申请内存, 并优先使用node节点的物理内存
+ *        size不小于HUGE_PAGE_SIZE时按huge_page_mode()使用大页, 地址按HUGE_PAGE_SIZE对齐
+ *
+ * @param size 内存大小
+ * @param node NUMA节点编号
+ * @return void* 内存地址, 失败时返回nullptr
+ */
+void *system_alloc(std::size_t size, std::size_t node);
+
+/**
+ * @brief 将system_alloc申请的内存返还给系统
+ *
+ * @param ptr 内存地址
+ * @param size 内存大小, 必须与申请时相同
+ */
+void system_free(void *ptr, std::size_t size);
+
+/**
+ * @brief 释放system_alloc申请的内存的物理页, 地址仍然有效, 再次写入时按原来的NUMA策略分配新的物理页, 内容为0
+ *
+ * @param ptr 内存地址, 按页对齐
+ * @param size 内存大小
+ */
+void system_release(void *ptr, std::size_t size);
+
+/**
+ * @brief 设置之后从系统申请的大块内存使用的页, 已经申请的内存不受影响
+ *
+ * @param mode 大页模式, 默认为HUGE_PAGE_MODE::NONE
+ */
+void set_huge_page_mode(HUGE_PAGE_MODE mode);
+HUGE_PAGE_MODE huge_page_mode();
+
+#endif /* __SYSTEM_ALLOC_HPP__ */
@@ -21,7 +21,7 @@ public:
 };
 
 template<typename T>
-ThreadPageHeap<T>::ThreadPageHeap() : _page_heap(std::make_shared<PageHeap<T>>()) {}
+ThreadPageHeap<T>::ThreadPageHeap() : _page_heap(PageHeap<T>::create()) {}
 
 template<typename T>
 ThreadPageHeap<T>::~ThreadPageHeap() {}
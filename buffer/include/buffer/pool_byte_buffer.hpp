@@ -9,5 +9,7 @@
 #include "buffer/pool/pool_byte_buffer_allocator.hpp"
 
 typedef BasicByteBuffer<Byte, PoolByteBufferAllocator<Byte>> PoolByteBuffer;
+typedef BasicSharedByteBuffer<Byte, PoolByteBufferAllocator<Byte>> PoolSharedByteBuffer;
+typedef BasicCompositeByteBuffer<Byte, PoolByteBufferAllocator<Byte>> PoolCompositeByteBuffer;
 
 #endif /* __POOL_BYTE_BUFFER_HPP__ */
@@ -0,0 +1,357 @@
+#ifndef __SHARED_BYTE_BUFFER_HPP__
+#define __SHARED_BYTE_BUFFER_HPP__
+
+#include <cstring>
+#include <cinttypes>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "buffer/byte.hpp"
+#include "buffer/type_traits.hpp"
+#include "buffer/basic_byte_buffer.hpp"
+
+template <typename T, typename Alloc, typename Enable = void>
+class BasicSharedByteBuffer
+{
+};
+
+/**
+ * @brief 引用计数的buffer视图, 多个视图共享同一块内存, 最后一个视图析构时使用分配器释放内存
+ *        每个视图有自己的[offset, offset + cap)范围以及read index和write index, 下标都相对于视图开始位置
+ *        slice和duplicate不copy内容, 通过视图写入的内容对共享内存的其他视图可见
+ *
+ * @tparam T 元素类型, 大小必须为1
+ * @tparam Alloc 分配器
+ */
+template <typename T, typename Alloc>
+class BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>
+{
+private:
+    //共享的内存块
+    struct Storage
+    {
+        T *bytes;
+        std::size_t cap;
+        Alloc allocator;
+
+        Storage(T *bytes, std::size_t cap, Alloc allocator) : bytes(bytes), cap(cap), allocator(allocator) {}
+        ~Storage()
+        {
+            if (bytes != nullptr)
+            {
+                allocator.deallocate(bytes, cap);
+            }
+        }
+        Storage(const Storage &) = delete;
+        Storage &operator=(const Storage &) = delete;
+    };
+
+    std::shared_ptr<Storage> _storage;
+    std::size_t _offset = 0;
+    std::size_t _cap = 0;
+    std::size_t _widx = 0;
+    std::size_t _ridx = 0;
+
+    BasicSharedByteBuffer(const std::shared_ptr<Storage> &storage, std::size_t offset, std::size_t cap, std::size_t ridx, std::size_t widx);
+
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef Alloc allocator_type;
+
+public:
+    BasicSharedByteBuffer();
+    /**
+     * @brief 申请cap大小的新内存
+     *
+     * @param cap 容量
+     * @param a 分配器
+     */
+    explicit BasicSharedByteBuffer(std::size_t cap, Alloc a = Alloc());
+    /**
+     * @brief 接管buffer的内存以及read index和write index, 不copy内容
+     *
+     * @param buffer 被接管的buffer, 之后变为空buffer
+     */
+    explicit BasicSharedByteBuffer(BasicByteBuffer<T, Alloc> &&buffer);
+
+    /**
+     * @brief 视图容量
+     *
+     * @return std::size_t 容量
+     */
+    std::size_t cap() const;
+    std::size_t writable() const;
+    std::size_t readable() const;
+    std::size_t read_index() const;
+    std::size_t write_index() const;
+    /**
+     * @brief 共享同一块内存的视图数量
+     *
+     * @return long 引用计数, 空视图返回0
+     */
+    long ref_count() const;
+
+    /**
+     * @brief 创建[index, index + len)范围的视图, 共享内存, 新视图的read index为0, write index为len
+     *
+     * @param index 相对于当前视图开始位置的下标
+     * @param len 长度, 超过当前视图的部分被截断
+     * @return BasicSharedByteBuffer 新视图
+     */
+    BasicSharedByteBuffer slice(std::size_t index, std::size_t len) const;
+    /**
+     * @brief 创建可读范围的视图, 共享内存
+     *
+     * @return BasicSharedByteBuffer 新视图
+     */
+    BasicSharedByteBuffer slice() const;
+    /**
+     * @brief 读取len个元素作为新视图, 并增加当前视图的read index, 用于从接收buffer中切分报文
+     *
+     * @param len 长度, 超过可读大小的部分被截断
+     * @return BasicSharedByteBuffer 新视图
+     */
+    BasicSharedByteBuffer read_slice(std::size_t len);
+    /**
+     * @brief 创建范围和下标都相同的视图, 共享内存, 之后两个视图的下标互不影响
+     *
+     * @return BasicSharedByteBuffer 新视图
+     */
+    BasicSharedByteBuffer duplicate() const;
+
+    /**
+     * @brief 得到视图开始位置的原始指针
+     *
+     * @return T* 原始指针, 空视图返回nullptr
+     */
+    T *data();
+    const T *const_data() const;
+    /**
+     * @brief 获取在read index + i 位置的元素引用
+     *
+     * @param i 要获取的位置
+     * @return T& 元素引用
+     */
+    T &operator[](std::size_t i);
+    /**
+     * @brief 将可读内容转换成string
+     *
+     * @return std::string 可读内容
+     */
+    std::string to_str() const;
+    /**
+     * @brief 增加read index, 最多增加到write index
+     *
+     * @param n 跳过的长度
+     * @return std::size_t 真正跳过的长度
+     */
+    std::size_t skip(std::size_t n);
+    /**
+     * @brief 读取数据到dst, 增加read index
+     *
+     * @tparam T2 读取元素类型, 可以是char, u_char, integral
+     * @param dst 目标地址
+     * @param size 长度
+     * @return std::size_t 读取到的长度, 可能小于指定长度
+     */
+    template <typename T2>
+    std::size_t read(typename is_readable<T2>::type *dst, std::size_t size);
+    /**
+     * @brief 追加写入到视图, 最多写入可写大小
+     *
+     * @tparam T2 元素类型
+     * @param src 内存位置
+     * @param size 写入大小
+     * @return std::size_t 真正写入大小
+     */
+    template <typename T2>
+    std::size_t write(const typename is_readable<T2>::type *src, std::size_t size);
+};
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicSharedByteBuffer() {}
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicSharedByteBuffer(const std::shared_ptr<Storage> &storage, std::size_t offset, std::size_t cap, std::size_t ridx, std::size_t widx)
+    : _storage(storage), _offset(offset), _cap(cap), _widx(widx), _ridx(ridx) {}
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicSharedByteBuffer(std::size_t cap, Alloc a)
+    : _cap(cap)
+{
+    T *bytes = a.allocate(cap);
+    _storage = std::make_shared<Storage>(bytes, cap, a);
+}
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::BasicSharedByteBuffer(BasicByteBuffer<T, Alloc> &&buffer)
+{
+    _cap = buffer.cap();
+    _ridx = buffer.read_index();
+    _widx = buffer.write_index();
+    Alloc a = buffer.get_allocator();
+    T *bytes = buffer.release();
+    if (bytes != nullptr)
+    {
+        _storage = std::make_shared<Storage>(bytes, _cap, a);
+    }
+    else
+    {
+        _cap = 0;
+        _ridx = 0;
+        _widx = 0;
+    }
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::cap() const
+{
+    return _cap;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::writable() const
+{
+    return _cap - _widx;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::readable() const
+{
+    return _widx - _ridx;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_index() const
+{
+    return _ridx;
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write_index() const
+{
+    return _widx;
+}
+
+template <typename T, typename Alloc>
+long BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::ref_count() const
+{
+    return _storage.use_count();
+}
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::slice(std::size_t index, std::size_t len) const
+{
+    if (index > _cap)
+    {
+        index = _cap;
+    }
+    if (len > _cap - index)
+    {
+        len = _cap - index;
+    }
+    return BasicSharedByteBuffer(_storage, _offset + index, len, 0, len);
+}
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::slice() const
+{
+    return slice(_ridx, readable());
+}
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read_slice(std::size_t len)
+{
+    if (len > readable())
+    {
+        len = readable();
+    }
+    auto res = slice(_ridx, len);
+    _ridx += len;
+    return res;
+}
+
+template <typename T, typename Alloc>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>
+BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::duplicate() const
+{
+    return BasicSharedByteBuffer(_storage, _offset, _cap, _ridx, _widx);
+}
+
+template <typename T, typename Alloc>
+T *BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::data()
+{
+    return _storage == nullptr ? nullptr : _storage->bytes + _offset;
+}
+
+template <typename T, typename Alloc>
+const T *BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::const_data() const
+{
+    return _storage == nullptr ? nullptr : _storage->bytes + _offset;
+}
+
+template <typename T, typename Alloc>
+T &BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::operator[](std::size_t i)
+{
+    return data()[_ridx + i];
+}
+
+template <typename T, typename Alloc>
+std::string BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::to_str() const
+{
+    if (_storage == nullptr)
+    {
+        return std::string();
+    }
+    return std::string((const char *)const_data() + _ridx, (const char *)const_data() + _widx);
+}
+
+template <typename T, typename Alloc>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::skip(std::size_t n)
+{
+    if (n > readable())
+    {
+        n = readable();
+    }
+    _ridx += n;
+    return n;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::read(typename is_readable<T2>::type *dst, std::size_t size)
+{
+    if (size > readable())
+    {
+        size = readable();
+    }
+    if (size != 0)
+    {
+        std::memcpy(dst, data() + _ridx, size);
+        _ridx += size;
+    }
+    return size;
+}
+
+template <typename T, typename Alloc>
+template <typename T2>
+std::size_t BasicSharedByteBuffer<T, Alloc, typename std::enable_if<sizeof(T) == 1>::type>::write(const typename is_readable<T2>::type *src, std::size_t size)
+{
+    if (size > writable())
+    {
+        size = writable();
+    }
+    if (size != 0)
+    {
+        std::memcpy(data() + _widx, src, size);
+        _widx += size;
+    }
+    return size;
+}
+
+#endif /* __SHARED_BYTE_BUFFER_HPP__ */
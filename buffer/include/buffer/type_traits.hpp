@@ -1,6 +1,9 @@
 #ifndef __TYPE_TRAITS_HPP__
 #define __TYPE_TRAITS_HPP__
 
+#include <cstddef>
+#include <utility>
+
 #include "buffer/byte.hpp"
 
 template <typename T, typename Enable = void>
@@ -18,4 +21,31 @@ struct is_readable<T, typename std::enable_if<
     typedef T type;
 };
 
+//Alloc是否提供good_size(n), 返回申请n个元素时真正得到的容量
+template <typename Alloc>
+struct has_good_size
+{
+private:
+    template <typename U>
+    static auto test(int) -> decltype(std::declval<U &>().good_size(std::size_t(0)), std::true_type());
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<Alloc>(0))::value;
+};
+
+//申请n个元素时真正得到的容量, Alloc没有提供good_size时为n
+template <typename Alloc>
+typename std::enable_if<has_good_size<Alloc>::value, std::size_t>::type alloc_good_size(Alloc &a, std::size_t n)
+{
+    return a.good_size(n);
+}
+
+template <typename Alloc>
+typename std::enable_if<!has_good_size<Alloc>::value, std::size_t>::type alloc_good_size(Alloc &a, std::size_t n)
+{
+    return n;
+}
+
 #endif /* __TYPE_TRAITS_HPP__ */
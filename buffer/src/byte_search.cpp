@@ -0,0 +1,307 @@
+#include <cstring>
+
+#include "buffer/byte_search.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BYTE_SEARCH_X86 1
+#endif
+
+namespace
+{
+    typedef std::size_t (*SearchByte)(const std::uint8_t *, std::size_t, std::uint8_t);
+    typedef std::size_t (*SearchAny)(const std::uint8_t *, std::size_t, const std::uint8_t *, std::size_t);
+    typedef std::size_t (*SearchPattern)(const std::uint8_t *, std::size_t, const std::uint8_t *, std::size_t);
+
+    //set不超过这个长度时使用SIMD比较
+    constexpr const std::size_t SIMD_SET_MAX = 16;
+
+    struct SearchImpl
+    {
+        const char *name;
+        SearchByte byte;
+        SearchAny any;
+        SearchPattern pattern;
+    };
+
+    std::size_t scalar_byte(const std::uint8_t *data, std::size_t len, std::uint8_t value)
+    {
+        for (std::size_t i = 0; i < len; i++)
+        {
+            if (data[i] == value)
+            {
+                return i;
+            }
+        }
+        return SEARCH_NPOS;
+    }
+
+    std::size_t scalar_any(const std::uint8_t *data, std::size_t len, const std::uint8_t *set, std::size_t set_len)
+    {
+        bool table[256] = {false};
+        for (std::size_t i = 0; i < set_len; i++)
+        {
+            table[set[i]] = true;
+        }
+        for (std::size_t i = 0; i < len; i++)
+        {
+            if (table[data[i]])
+            {
+                return i;
+            }
+        }
+        return SEARCH_NPOS;
+    }
+
+    //从from开始逐个位置比较, 用于SIMD处理后剩余不足一个向量的部分, 调用方保证pattern_len >= 2
+    std::size_t scalar_pattern_from(const std::uint8_t *data, std::size_t len, const std::uint8_t *pattern, std::size_t pattern_len, std::size_t from)
+    {
+        for (std::size_t i = from; i + pattern_len <= len; i++)
+        {
+            if (data[i] == pattern[0] && data[i + pattern_len - 1] == pattern[pattern_len - 1] &&
+                std::memcmp(data + i + 1, pattern + 1, pattern_len - 2) == 0)
+            {
+                return i;
+            }
+        }
+        return SEARCH_NPOS;
+    }
+
+    std::size_t scalar_pattern(const std::uint8_t *data, std::size_t len, const std::uint8_t *pattern, std::size_t pattern_len)
+    {
+        return scalar_pattern_from(data, len, pattern, pattern_len, 0);
+    }
+
+    std::size_t tail_byte(const std::uint8_t *data, std::size_t len, std::size_t from, std::uint8_t value)
+    {
+        std::size_t res = scalar_byte(data + from, len - from, value);
+        return res == SEARCH_NPOS ? res : from + res;
+    }
+
+    std::size_t tail_any(const std::uint8_t *data, std::size_t len, std::size_t from, const std::uint8_t *set, std::size_t set_len)
+    {
+        for (std::size_t i = from; i < len; i++)
+        {
+            for (std::size_t j = 0; j < set_len; j++)
+            {
+                if (data[i] == set[j])
+                {
+                    return i;
+                }
+            }
+        }
+        return SEARCH_NPOS;
+    }
+
+#ifdef BYTE_SEARCH_X86
+    __attribute__((target("sse2"))) std::size_t sse2_byte(const std::uint8_t *data, std::size_t len, std::uint8_t value)
+    {
+        const __m128i needle = _mm_set1_epi8((char)value);
+        std::size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+            if (mask != 0)
+            {
+                return i + __builtin_ctz(mask);
+            }
+        }
+        return tail_byte(data, len, i, value);
+    }
+
+    __attribute__((target("sse2"))) std::size_t sse2_any(const std::uint8_t *data, std::size_t len, const std::uint8_t *set, std::size_t set_len)
+    {
+        if (set_len > SIMD_SET_MAX)
+        {
+            return scalar_any(data, len, set, set_len);
+        }
+        __m128i needles[SIMD_SET_MAX];
+        for (std::size_t j = 0; j < set_len; j++)
+        {
+            needles[j] = _mm_set1_epi8((char)set[j]);
+        }
+        std::size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+            __m128i eq = _mm_setzero_si128();
+            for (std::size_t j = 0; j < set_len; j++)
+            {
+                eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, needles[j]));
+            }
+            int mask = _mm_movemask_epi8(eq);
+            if (mask != 0)
+            {
+                return i + __builtin_ctz(mask);
+            }
+        }
+        return tail_any(data, len, i, set, set_len);
+    }
+
+    __attribute__((target("sse2"))) std::size_t sse2_pattern(const std::uint8_t *data, std::size_t len, const std::uint8_t *pattern, std::size_t pattern_len)
+    {
+        const __m128i first = _mm_set1_epi8((char)pattern[0]);
+        const __m128i last = _mm_set1_epi8((char)pattern[pattern_len - 1]);
+        std::size_t i = 0;
+        //一次检查16个起始位置, 第一个和最后一个字节都相等的才需要memcmp
+        for (; i + pattern_len - 1 + 16 <= len; i += 16)
+        {
+            __m128i block_first = _mm_loadu_si128((const __m128i *)(data + i));
+            __m128i block_last = _mm_loadu_si128((const __m128i *)(data + i + pattern_len - 1));
+            unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+            while (mask != 0)
+            {
+                std::size_t pos = i + __builtin_ctz(mask);
+                if (std::memcmp(data + pos + 1, pattern + 1, pattern_len - 2) == 0)
+                {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+        return scalar_pattern_from(data, len, pattern, pattern_len, i);
+    }
+
+    __attribute__((target("avx2"))) std::size_t avx2_byte(const std::uint8_t *data, std::size_t len, std::uint8_t value)
+    {
+        const __m256i needle = _mm256_set1_epi8((char)value);
+        std::size_t i = 0;
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+            if (mask != 0)
+            {
+                return i + __builtin_ctz(mask);
+            }
+        }
+        //剩余不足32字节的部分交给SSE2
+        std::size_t res = sse2_byte(data + i, len - i, value);
+        return res == SEARCH_NPOS ? res : i + res;
+    }
+
+    __attribute__((target("avx2"))) std::size_t avx2_any(const std::uint8_t *data, std::size_t len, const std::uint8_t *set, std::size_t set_len)
+    {
+        if (set_len > SIMD_SET_MAX)
+        {
+            return scalar_any(data, len, set, set_len);
+        }
+        __m256i needles[SIMD_SET_MAX];
+        for (std::size_t j = 0; j < set_len; j++)
+        {
+            needles[j] = _mm256_set1_epi8((char)set[j]);
+        }
+        std::size_t i = 0;
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+            __m256i eq = _mm256_setzero_si256();
+            for (std::size_t j = 0; j < set_len; j++)
+            {
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(block, needles[j]));
+            }
+            unsigned mask = (unsigned)_mm256_movemask_epi8(eq);
+            if (mask != 0)
+            {
+                return i + __builtin_ctz(mask);
+            }
+        }
+        std::size_t res = sse2_any(data + i, len - i, set, set_len);
+        return res == SEARCH_NPOS ? res : i + res;
+    }
+
+    __attribute__((target("avx2"))) std::size_t avx2_pattern(const std::uint8_t *data, std::size_t len, const std::uint8_t *pattern, std::size_t pattern_len)
+    {
+        const __m256i first = _mm256_set1_epi8((char)pattern[0]);
+        const __m256i last = _mm256_set1_epi8((char)pattern[pattern_len - 1]);
+        std::size_t i = 0;
+        for (; i + pattern_len - 1 + 32 <= len; i += 32)
+        {
+            __m256i block_first = _mm256_loadu_si256((const __m256i *)(data + i));
+            __m256i block_last = _mm256_loadu_si256((const __m256i *)(data + i + pattern_len - 1));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last)));
+            while (mask != 0)
+            {
+                std::size_t pos = i + __builtin_ctz(mask);
+                if (std::memcmp(data + pos + 1, pattern + 1, pattern_len - 2) == 0)
+                {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+        std::size_t res = sse2_pattern(data + i, len - i, pattern, pattern_len);
+        return res == SEARCH_NPOS ? res : i + res;
+    }
+#endif
+
+    SearchImpl select_impl()
+    {
+#ifdef BYTE_SEARCH_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SearchImpl{"avx2", avx2_byte, avx2_any, avx2_pattern};
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return SearchImpl{"sse2", sse2_byte, sse2_any, sse2_pattern};
+        }
+#endif
+        return SearchImpl{"scalar", scalar_byte, scalar_any, scalar_pattern};
+    }
+
+    //第一次使用时检测CPU, 静态初始化阶段调用也是安全的
+    const SearchImpl &impl()
+    {
+        static const SearchImpl res = select_impl();
+        return res;
+    }
+}
+
+std::size_t search_byte(const void *data, std::size_t len, std::uint8_t value)
+{
+    return impl().byte((const std::uint8_t *)data, len, value);
+}
+
+std::size_t search_any(const void *data, std::size_t len, const void *set, std::size_t set_len)
+{
+    if (set_len == 0)
+    {
+        return SEARCH_NPOS;
+    }
+    if (set_len == 1)
+    {
+        return search_byte(data, len, *(const std::uint8_t *)set);
+    }
+    return impl().any((const std::uint8_t *)data, len, (const std::uint8_t *)set, set_len);
+}
+
+std::size_t search_pattern(const void *data, std::size_t len, const void *pattern, std::size_t pattern_len)
+{
+    if (pattern_len == 0)
+    {
+        return 0;
+    }
+    if (pattern_len > len)
+    {
+        return SEARCH_NPOS;
+    }
+    if (pattern_len == 1)
+    {
+        return search_byte(data, len, *(const std::uint8_t *)pattern);
+    }
+    return impl().pattern((const std::uint8_t *)data, len, (const std::uint8_t *)pattern, pattern_len);
+}
+
+std::size_t search_crlf(const void *data, std::size_t len)
+{
+    //长度为2时第一个和最后一个字节比较即可确定, 不需要memcmp
+    return search_pattern(data, len, "\r\n", 2);
+}
+
+const char *search_impl_name()
+{
+    return impl().name;
+}
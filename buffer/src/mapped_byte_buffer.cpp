@@ -0,0 +1,223 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include "buffer/mapped_byte_buffer.hpp"
+
+namespace
+{
+    int to_madvise(MAP_ADVICE advice)
+    {
+        switch (advice)
+        {
+        case MAP_ADVICE::SEQUENTIAL:
+            return MADV_SEQUENTIAL;
+        case MAP_ADVICE::RANDOM:
+            return MADV_RANDOM;
+        case MAP_ADVICE::WILLNEED:
+            return MADV_WILLNEED;
+        default:
+            return MADV_NORMAL;
+        }
+    }
+
+    int open_flags(MAP_MODE mode)
+    {
+        switch (mode)
+        {
+        case MAP_MODE::READ_WRITE:
+            return O_RDWR | O_CREAT;
+        case MAP_MODE::TRUNCATE:
+            return O_RDWR | O_CREAT | O_TRUNC;
+        default:
+            return O_RDONLY;
+        }
+    }
+
+    std::runtime_error map_error(const std::string &what, const std::string &path)
+    {
+        return std::runtime_error("MappedByteBuffer " + what + " " + path + ": " + std::strerror(errno));
+    }
+}
+
+Byte *MappedAllocator::allocate(std::size_t n)
+{
+    if (n == 0)
+    {
+        return nullptr;
+    }
+    void *p = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    return (Byte *)p;
+}
+
+void MappedAllocator::deallocate(Byte *p, std::size_t n)
+{
+    if (p != nullptr && n != 0)
+    {
+        munmap(p, n);
+    }
+}
+
+std::size_t MappedAllocator::good_size(std::size_t n) const
+{
+    std::size_t page = (std::size_t)sysconf(_SC_PAGESIZE);
+    return (n + page - 1) / page * page;
+}
+
+MappedByteBuffer::MappedByteBuffer() {}
+
+MappedByteBuffer::MappedByteBuffer(const std::string &path, MAP_MODE mode, std::size_t size, MAP_ADVICE advice)
+    : _mode(mode)
+{
+    bool shared = mode != MAP_MODE::READ_ONLY;
+    int fd = open(path.c_str(), open_flags(mode), 0644);
+    if (fd < 0)
+    {
+        throw map_error("open", path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw map_error("stat", path);
+    }
+    std::size_t len = (std::size_t)st.st_size;
+    std::size_t cap = len;
+    bool extended = false;
+    if (shared && size > len)
+    {
+        if (ftruncate(fd, (off_t)size) != 0)
+        {
+            close(fd);
+            throw map_error("truncate", path);
+        }
+        cap = size;
+        extended = true;
+    }
+    //空文件不能映射, 作为空buffer
+    if (cap == 0)
+    {
+        close(fd);
+        return;
+    }
+    //READ_ONLY也使用可写的私有映射, discard_read_bytes等移动内容的操作不会因为写只读页而崩溃
+    int flags = shared ? MAP_SHARED : MAP_PRIVATE;
+    void *p = mmap(nullptr, cap, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (p == MAP_FAILED)
+    {
+        close(fd);
+        throw map_error("mmap", path);
+    }
+    //映射建立后关闭文件不影响映射, 扩展过文件时保留用于截断
+    if (extended)
+    {
+        _fd = fd;
+    }
+    else
+    {
+        close(fd);
+    }
+    _file_size = cap;
+    adopt((Byte *)p, len, cap);
+    advise(advice);
+}
+
+MappedByteBuffer::MappedByteBuffer(MappedByteBuffer &&other) noexcept
+    : BasicByteBuffer<Byte, MappedAllocator>(std::move(other)), _mode(other._mode), _fd(other._fd), _file_size(other._file_size)
+{
+    other._fd = -1;
+    other._file_size = 0;
+}
+
+MappedByteBuffer::~MappedByteBuffer()
+{
+    unmap();
+}
+
+MappedByteBuffer &MappedByteBuffer::operator=(MappedByteBuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        BasicByteBuffer<Byte, MappedAllocator>::operator=(std::move(other));
+        _mode = other._mode;
+        _fd = other._fd;
+        _file_size = other._file_size;
+        other._fd = -1;
+        other._file_size = 0;
+    }
+    return *this;
+}
+
+MAP_MODE MappedByteBuffer::mode() const
+{
+    return _mode;
+}
+
+void MappedByteBuffer::advise(MAP_ADVICE advice)
+{
+    if (_bytes != nullptr)
+    {
+        madvise(_bytes, _cap, to_madvise(advice));
+    }
+}
+
+void MappedByteBuffer::sync()
+{
+    if (_mode != MAP_MODE::READ_ONLY && _bytes != nullptr && msync(_bytes, _cap, MS_SYNC) != 0)
+    {
+        throw map_error("msync", "");
+    }
+}
+
+void MappedByteBuffer::discard_read_bytes()
+{
+    if (_mode == MAP_MODE::READ_ONLY)
+    {
+        BasicByteBuffer<Byte, MappedAllocator>::discard_read_bytes();
+    }
+}
+
+void MappedByteBuffer::compact()
+{
+    if (_mode == MAP_MODE::READ_ONLY)
+    {
+        BasicByteBuffer<Byte, MappedAllocator>::compact();
+    }
+}
+
+void MappedByteBuffer::set_compact_threshold(double ratio)
+{
+    if (_mode == MAP_MODE::READ_ONLY)
+    {
+        BasicByteBuffer<Byte, MappedAllocator>::set_compact_threshold(ratio);
+    }
+}
+
+void MappedByteBuffer::unmap()
+{
+    if (_fd >= 0)
+    {
+        //扩容后内容不在文件中, 文件最多保留映射时的大小, 析构时调用不能抛出异常, 截断失败时保留原来的大小
+        int res = ftruncate(_fd, (off_t)(_widx < _file_size ? _widx : _file_size));
+        (void)res;
+        close(_fd);
+        _fd = -1;
+    }
+    if (_bytes != nullptr)
+    {
+        _allocator.deallocate(_bytes, _cap);
+    }
+    release();
+    _file_size = 0;
+}
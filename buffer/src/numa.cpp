@@ -0,0 +1,73 @@
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include <fstream>
+#include <string>
+
+#include "buffer/pool/constant.hpp"
+#include "buffer/pool/numa.hpp"
+
+namespace
+{
+    // linux/mempolicy.h
+    constexpr const int MPOL_PREFERRED_MODE = 1;
+
+    std::size_t read_node_count()
+    {
+        //格式为"0"或"0-1"或"0,2-3", 取最大的节点编号
+        std::ifstream in("/sys/devices/system/node/online");
+        std::string online;
+        if (!(in >> online))
+        {
+            return 1;
+        }
+        std::size_t max_node = 0;
+        std::size_t value = 0;
+        for (auto c : online)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                value = value * 10 + (c - '0');
+            }
+            else
+            {
+                max_node = value > max_node ? value : max_node;
+                value = 0;
+            }
+        }
+        max_node = value > max_node ? value : max_node;
+        return max_node + 1 < MAX_NUMA_NODES ? max_node + 1 : MAX_NUMA_NODES;
+    }
+}
+
+std::size_t numa_node_count()
+{
+    static std::size_t count = read_node_count();
+    return count;
+}
+
+std::size_t numa_current_node()
+{
+    if (numa_node_count() == 1)
+    {
+        return 0;
+    }
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+    {
+        return 0;
+    }
+    return node % numa_node_count();
+}
+
+void numa_bind(void *ptr, std::size_t size, std::size_t node)
+{
+    if (numa_node_count() == 1)
+    {
+        return;
+    }
+    unsigned long mask = 1UL << node;
+    //绑定失败时使用默认策略(first-touch), 不影响正确性
+    syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_MODE, &mask, sizeof(mask) * 8, 0);
+}
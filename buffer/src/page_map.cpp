@@ -0,0 +1,117 @@
+#include "buffer/pool/page_map.hpp"
+
+namespace
+{
+    //记录格式: 有效位(1) | owner(16) | type(2) | node(3) | index(42)
+    constexpr const std::uint64_t VALID_BIT = 1ULL << 63;
+    constexpr const unsigned OWNER_SHIFT = 47;
+    constexpr const unsigned TYPE_SHIFT = 45;
+    constexpr const unsigned NODE_SHIFT = 42;
+    constexpr const std::uint64_t NODE_MASK = 7;
+    constexpr const std::uint64_t INDEX_MASK = (1ULL << NODE_SHIFT) - 1;
+
+    static_assert(MAX_NUMA_NODES <= NODE_MASK + 1, "node field too small for MAX_NUMA_NODES");
+}
+
+PageMap::PageMap()
+{
+    for (std::size_t i = 0; i < LEVEL_LEN; i++)
+    {
+        _root[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+PageMap *PageMap::instance()
+{
+    static PageMap *page_map = new PageMap();
+    return page_map;
+}
+
+std::atomic<std::uint64_t> *PageMap::value(const void *ptr, bool create)
+{
+    std::uint64_t page = (std::uint64_t)(std::uintptr_t)ptr >> PAGE_SHIFT;
+    if ((page >> (3 * LEVEL_BITS)) != 0)
+    {
+        return nullptr;
+    }
+    std::size_t i0 = page >> (2 * LEVEL_BITS);
+    std::size_t i1 = (page >> LEVEL_BITS) & (LEVEL_LEN - 1);
+    std::size_t i2 = page & (LEVEL_LEN - 1);
+
+    Node *node = _root[i0].load(std::memory_order_acquire);
+    if (node == nullptr)
+    {
+        if (!create)
+        {
+            return nullptr;
+        }
+        //多个线程同时创建时只保留一个
+        Node *fresh = new Node();
+        if (_root[i0].compare_exchange_strong(node, fresh))
+        {
+            node = fresh;
+        }
+        else
+        {
+            delete fresh;
+        }
+    }
+
+    Leaf *leaf = node->leaves[i1].load(std::memory_order_acquire);
+    if (leaf == nullptr)
+    {
+        if (!create)
+        {
+            return nullptr;
+        }
+        Leaf *fresh = new Leaf();
+        if (node->leaves[i1].compare_exchange_strong(leaf, fresh))
+        {
+            leaf = fresh;
+        }
+        else
+        {
+            delete fresh;
+        }
+    }
+    return &leaf->values[i2];
+}
+
+void PageMap::set(const void *ptr, const Entry &entry)
+{
+    auto v = value(ptr, true);
+    if (v != nullptr)
+    {
+        v->store(VALID_BIT | ((std::uint64_t)entry.owner << OWNER_SHIFT) | ((std::uint64_t)entry.type << TYPE_SHIFT) |
+                     (((std::uint64_t)entry.node & NODE_MASK) << NODE_SHIFT) | (entry.index & INDEX_MASK),
+                 std::memory_order_release);
+    }
+}
+
+bool PageMap::get(const void *ptr, Entry &entry)
+{
+    auto v = value(ptr, false);
+    if (v == nullptr)
+    {
+        return false;
+    }
+    std::uint64_t bits = v->load(std::memory_order_acquire);
+    if ((bits & VALID_BIT) == 0)
+    {
+        return false;
+    }
+    entry.owner = (std::uint16_t)(bits >> OWNER_SHIFT);
+    entry.type = (PAGE_SIZE_TYPE)((bits >> TYPE_SHIFT) & 3);
+    entry.node = (std::uint8_t)((bits >> NODE_SHIFT) & NODE_MASK);
+    entry.index = bits & INDEX_MASK;
+    return true;
+}
+
+void PageMap::clear(const void *ptr)
+{
+    auto v = value(ptr, false);
+    if (v != nullptr)
+    {
+        v->store(0, std::memory_order_release);
+    }
+}
@@ -0,0 +1,52 @@
+#include <sstream>
+
+#include "buffer/pool/pool_stats.hpp"
+
+static const char *type_name(PAGE_SIZE_TYPE type)
+{
+    switch (type)
+    {
+    case PAGE_SIZE_TYPE::SMALL:
+        return "SMALL";
+    case PAGE_SIZE_TYPE::NORMAL:
+        return "NORMAL";
+    case PAGE_SIZE_TYPE::BIG:
+        return "BIG";
+    default:
+        return "UNMANAGE";
+    }
+}
+
+static void classes_to_str(std::ostringstream &out, const std::vector<SizeClassStats> &classes)
+{
+    for (auto &cls : classes)
+    {
+        out << "    " << type_name(cls.type) << "[" << cls.index << "] size=" << cls.size
+            << " blocks=" << cls.blocks << " bytes=" << cls.size * cls.blocks << "\n";
+    }
+}
+
+std::string PoolStats::to_str() const
+{
+    std::ostringstream out;
+    std::uint64_t cached_bytes = central.cached_bytes;
+    for (auto &thread : threads)
+    {
+        cached_bytes += thread.cached_bytes;
+    }
+
+    out << "pool: threads=" << threads.size() << " system_bytes=" << central.system_bytes
+        << " cached_bytes=" << cached_bytes << "\n";
+    out << "central: cached_bytes=" << central.cached_bytes << "\n";
+    classes_to_str(out, central.classes);
+    for (auto &thread : threads)
+    {
+        out << "thread " << thread.thread_id << ": node=" << thread.node << " allocs=" << thread.allocs << " frees=" << thread.frees
+            << " remote_frees=" << thread.remote_frees << " remote_depth=" << thread.remote_depth
+            << " remote_pending=" << thread.remote_pending
+            << " central_fetches=" << thread.central_fetches << " central_releases=" << thread.central_releases
+            << " unmanage_allocs=" << thread.unmanage_allocs << " cached_bytes=" << thread.cached_bytes << "\n";
+        classes_to_str(out, thread.classes);
+    }
+    return out.str();
+}
@@ -1,8 +1,94 @@
 #include <cinttypes>
-#include <cmath>
+#include <cstddef>
 
 #include "buffer/pool/size_class.hpp"
 
+namespace
+{
+    // SMALL size class:
+    // 16B ~ 256B, 增长为16B, 共16个
+    // 256B ~ 2048B, 每个2的幂区间分为4个, 共12个
+    constexpr std::uint64_t SMALL_STEP_SHIFT = 4;
+    constexpr std::uint64_t SMALL_LINEAR_LEN = 16;
+    constexpr std::uint64_t SMALL_LINEAR_MAX = SMALL_LINEAR_LEN << SMALL_STEP_SHIFT;
+
+    // size class下标转换为size
+    constexpr std::uint64_t small_class_size(std::uint64_t index)
+    {
+        return index < SMALL_LINEAR_LEN
+                   ? (index + 1) << SMALL_STEP_SHIFT
+                   : (SMALL_LINEAR_MAX << ((index - SMALL_LINEAR_LEN) / 4)) +
+                         ((index - SMALL_LINEAR_LEN) % 4 + 1) * (SMALL_LINEAR_MAX >> 2 << ((index - SMALL_LINEAR_LEN) / 4));
+    }
+
+    // size所在2的幂区间(2^k, 2^(k+1)]的k, 只用于256B ~ 2048B
+    constexpr std::uint64_t small_geometric_shift(std::uint64_t size)
+    {
+        return size - 1 >= 1024 ? 10 : (size - 1 >= 512 ? 9 : 8);
+    }
+
+    // 以16B为单位的size转换为size class下标
+    constexpr std::uint64_t small_class_index(std::uint64_t granule)
+    {
+        return (granule << SMALL_STEP_SHIFT) <= SMALL_LINEAR_MAX
+                   ? (granule == 0 ? 0 : granule - 1)
+                   : SMALL_LINEAR_LEN + (small_geometric_shift(granule << SMALL_STEP_SHIFT) - 8) * 4 +
+                         ((granule << SMALL_STEP_SHIFT) - (1ULL << small_geometric_shift(granule << SMALL_STEP_SHIFT)) +
+                          (1ULL << (small_geometric_shift(granule << SMALL_STEP_SHIFT) - 2)) - 1) /
+                             (1ULL << (small_geometric_shift(granule << SMALL_STEP_SHIFT) - 2)) -
+                         1;
+    }
+
+    template <std::size_t... I>
+    struct IndexSequence
+    {
+    };
+
+    template <std::size_t N, std::size_t... I>
+    struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...>
+    {
+    };
+
+    template <std::size_t... I>
+    struct MakeIndexSequence<0, I...>
+    {
+        typedef IndexSequence<I...> type;
+    };
+
+    template <typename Seq>
+    struct SmallTables;
+
+    //编译期生成的查找表, 分配和释放时不需要浮点运算和分支
+    template <std::size_t... I>
+    struct SmallTables<IndexSequence<I...>>
+    {
+        // (size + 15) >> 4 => size class下标
+        static constexpr std::uint8_t index[] = {static_cast<std::uint8_t>(small_class_index(I))...};
+    };
+
+    template <std::size_t... I>
+    constexpr std::uint8_t SmallTables<IndexSequence<I...>>::index[];
+
+    template <typename Seq>
+    struct SmallSizes;
+
+    template <std::size_t... I>
+    struct SmallSizes<IndexSequence<I...>>
+    {
+        // size class下标 => size
+        static constexpr std::uint64_t size[] = {small_class_size(I)...};
+    };
+
+    template <std::size_t... I>
+    constexpr std::uint64_t SmallSizes<IndexSequence<I...>>::size[];
+
+    typedef SmallTables<MakeIndexSequence<(SMALL_MAX_SIZE >> SMALL_STEP_SHIFT) + 1>::type> SmallIndexTable;
+    typedef SmallSizes<MakeIndexSequence<SMALLS_LEN>::type> SmallSizeTable;
+
+    static_assert(small_class_size(SMALLS_LEN - 1) == SMALL_MAX_SIZE, "the last small size class must be SMALL_MAX_SIZE");
+    static_assert(small_class_index(SMALL_MAX_SIZE >> SMALL_STEP_SHIFT) == SMALLS_LEN - 1, "SMALL_MAX_SIZE must map to the last small size class");
+}
+
 SizeClass::SizeClass()
 {
 }
@@ -16,15 +102,15 @@ PAGE_SIZE_TYPE SizeClass::size_type(std::uint64_t size)
     // size <= 2048, SMALL
     // 2048 < size <= 16M, NORMAL
     // 16M < size <= 64M, BIG
-    if (size <= 2048)
+    if (size <= SMALL_MAX_SIZE)
     {
         return PAGE_SIZE_TYPE::SMALL;
     }
-    else if (size <= 16 * MB)
+    else if (size <= NORMAL_MAX_SIZE)
     {
         return PAGE_SIZE_TYPE::NORMAL;
     }
-    else if (size <= 64 * MB)
+    else if (size <= HUGE_MAX_SIZE)
     {
         return PAGE_SIZE_TYPE::BIG;
     }
@@ -39,7 +125,7 @@ SizeClass::SizeInfo SizeClass::size_info(std::uint64_t size)
     // size <= 2048, SMALL
     // 2048 < size <= 16M, NORMAL
     // 16M < size <= 64M, BIG
-    if (size <= 2048)
+    if (size <= SMALL_MAX_SIZE)
     {
         auto idx = small_size_to_index(size);
         return SizeInfo{
@@ -48,22 +134,22 @@ SizeClass::SizeInfo SizeClass::size_info(std::uint64_t size)
             free_list_index : idx,
         };
     }
-    else if (size <= 16 * MB)
+    else if (size <= NORMAL_MAX_SIZE)
     {
         auto idx = normal_size_to_index(size);
         return SizeInfo{
             size_type : PAGE_SIZE_TYPE::NORMAL,
             cap : normal_index_to_size(idx),
-            free_list_index : normal_size_to_index(size),
+            free_list_index : idx,
         };
     }
-    else if (size <= 64 * MB)
+    else if (size <= HUGE_MAX_SIZE)
     {
-        auto idx = normal_size_to_index(size);
+        auto idx = huge_size_to_index(size);
         return SizeInfo{
             size_type : PAGE_SIZE_TYPE::BIG,
             cap : huge_index_to_size(idx),
-            free_list_index : huge_size_to_index(size),
+            free_list_index : idx,
         };
     }
     else
@@ -78,32 +164,32 @@ SizeClass::SizeInfo SizeClass::size_info(std::uint64_t size)
 
 std::uint64_t SizeClass::small_size_to_index(std::uint64_t size)
 {
-    // 2**6=64, 最小分配16字节
-    std::uint64_t idx = ceil(std::log2(size));
-    return idx < SMALLS_MIN_IDX ? SMALLS_MIN_IDX : idx;
+    return SmallIndexTable::index[(size + (1ULL << SMALL_STEP_SHIFT) - 1) >> SMALL_STEP_SHIFT];
 }
 
 std::uint64_t SizeClass::normal_size_to_index(std::uint64_t size)
 {
-    return (size + 1) / (4 * KB) + 1;
+    // 4KB ~ 16MB, 下标1对应4KB
+    return (size + 4 * KB - 1) >> 12;
 }
 
 std::uint64_t SizeClass::huge_size_to_index(std::uint64_t size)
 {
-    return (size - 16 * MB) / MB;
+    // 17MB ~ 64MB, 下标0对应17MB
+    return (size - NORMAL_MAX_SIZE - 1) >> 20;
 }
 
 std::uint64_t SizeClass::small_index_to_size(std::uint64_t index)
 {
-    return 1ULL << index;
+    return SmallSizeTable::size[index];
 }
 
 std::uint64_t SizeClass::normal_index_to_size(std::uint64_t index)
 {
-    return 4 * KB * index;
+    return index << 12;
 }
 
 std::uint64_t SizeClass::huge_index_to_size(std::uint64_t index)
 {
-    return 16 * MB * (index + 1) + 1 * MB;
-}
\ No newline at end of file
+    return NORMAL_MAX_SIZE + ((index + 1) << 20);
+}
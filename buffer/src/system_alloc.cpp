@@ -0,0 +1,92 @@
+#include <sys/mman.h>
+
+#include <atomic>
+
+#include "buffer/pool/system_alloc.hpp"
+#include "buffer/pool/numa.hpp"
+
+namespace
+{
+    constexpr const std::size_t PAGE = 4 * KB;
+
+    std::atomic<HUGE_PAGE_MODE> mode{HUGE_PAGE_MODE::NONE};
+
+    std::size_t align_up(std::size_t size, std::size_t align)
+    {
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    //申请按HUGE_PAGE_SIZE对齐的内存, 失败时返回nullptr
+    void *huge_alloc(std::size_t size, HUGE_PAGE_MODE huge_mode)
+    {
+#ifdef MAP_HUGETLB
+        if (huge_mode == HUGE_PAGE_MODE::EXPLICIT && size % HUGE_PAGE_SIZE == 0)
+        {
+            void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED)
+            {
+                return ptr;
+            }
+        }
+#endif
+        //多申请一个大页, 截掉头尾得到对齐的地址
+        std::size_t len = align_up(size, PAGE);
+        char *raw = (char *)system_alloc(len + HUGE_PAGE_SIZE);
+        if (raw == nullptr)
+        {
+            return nullptr;
+        }
+        char *aligned = (char *)align_up((std::size_t)raw, HUGE_PAGE_SIZE);
+        if (aligned != raw)
+        {
+            munmap(raw, aligned - raw);
+        }
+        std::size_t tail = (raw + len + HUGE_PAGE_SIZE) - (aligned + len);
+        if (tail != 0)
+        {
+            munmap(aligned + len, tail);
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+        return aligned;
+    }
+}
+
+void *system_alloc(std::size_t size)
+{
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+void *system_alloc(std::size_t size, std::size_t node)
+{
+    HUGE_PAGE_MODE huge_mode = mode.load(std::memory_order_relaxed);
+    void *ptr = size >= HUGE_PAGE_SIZE && huge_mode != HUGE_PAGE_MODE::NONE ? huge_alloc(size, huge_mode) : system_alloc(size);
+    if (ptr != nullptr)
+    {
+        //在第一次写入之前绑定, 物理页在写入时从node分配
+        numa_bind(ptr, size, node);
+    }
+    return ptr;
+}
+
+void system_free(void *ptr, std::size_t size)
+{
+    munmap(ptr, size);
+}
+
+void system_release(void *ptr, std::size_t size)
+{
+    madvise(ptr, size, MADV_DONTNEED);
+}
+
+void set_huge_page_mode(HUGE_PAGE_MODE huge_mode)
+{
+    mode.store(huge_mode, std::memory_order_relaxed);
+}
+
+HUGE_PAGE_MODE huge_page_mode()
+{
+    return mode.load(std::memory_order_relaxed);
+}
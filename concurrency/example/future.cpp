@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "concurrency/thread/thread.hpp"
+#include "concurrency/thread/named_thread_factory.hpp"
+#include "concurrency/concurrent_queue/linked_blocking_queue.hpp"
+#include "concurrency/executor/thread_pool_executor.hpp"
+
+int main(int argc, char const *argv[])
+{
+    ThreadPoolExecutor<LinkedBlockingQueue<std::shared_ptr<ExecutorTask>>> executor(4, std::make_shared<NamedThreadFactory>("future"));
+    executor.start();
+
+    //后续任务在线程池中执行, 不阻塞任务线程
+    auto length = executor.submit([](const std::string &s)
+                                  { return s + " world"; },
+                                  std::string("hello"))
+                      .then([](Future<std::string> f)
+                            {
+                                std::string s = f.get();
+                                std::cout << current_thread_name() << ": " << s << std::endl;
+                                return s.size();
+                            });
+    std::cout << "length: " << length.get() << std::endl;
+
+    std::vector<Future<int>> parts;
+    for (int i = 0; i < 10; i++)
+    {
+        parts.push_back(executor.submit([i]()
+                                        { return i * i; }));
+    }
+    auto sum = when_all(std::move(parts)).then([](Future<std::vector<Future<int>>> f)
+                                               {
+                                                   int res = 0;
+                                                   for (auto &part : f.get())
+                                                   {
+                                                       res += part.get();
+                                                   }
+                                                   return res;
+                                               });
+    std::cout << "sum: " << sum.get() << std::endl;
+
+    auto error = executor.submit([]() -> int
+                                 { throw std::runtime_error("failed"); });
+    try
+    {
+        error.get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "error: " << e.what() << std::endl;
+    }
+
+    executor.shutdown();
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <ctime>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "concurrency/thread/named_thread_factory.hpp"
+#include "concurrency/concurrent_queue/array_blocking_queue.hpp"
+#include "concurrency/executor/thread_pool_executor.hpp"
+
+using Clock = std::chrono::steady_clock;
+using Pool = ThreadPoolExecutor<ArrayBlockingQueue<std::shared_ptr<ExecutorTask>, 64>>;
+
+//空闲的任务线程休眠, 放入任务时被唤醒, 返回从放入到开始执行的平均延迟(微秒)
+double wake_latency(Pool &executor, int rounds)
+{
+    double total = 0;
+    for (int i = 0; i < rounds; i++)
+    {
+        //等待任务线程进入休眠或自旋
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::atomic<bool> done(false);
+        Clock::time_point start = Clock::now();
+        Clock::time_point run;
+        executor.execute([&]()
+                         {
+                             run = Clock::now();
+                             done = true;
+                         });
+        while (!done)
+        {
+            std::this_thread::yield();
+        }
+        total += std::chrono::duration_cast<std::chrono::nanoseconds>(run - start).count() / 1000.0;
+    }
+    return total / rounds;
+}
+
+int main(int argc, char const *argv[])
+{
+    auto *executor = new Pool(4, std::make_shared<NamedThreadFactory>("idle"));
+    executor->start();
+
+    //没有任务时任务线程休眠, 不会周期性地醒来检查队列, 几乎不消耗cpu
+    std::clock_t cpu = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    double idle_ms = (std::clock() - cpu) * 1000.0 / CLOCKS_PER_SEC;
+    std::cout << "cpu time of 4 idle workers in 200ms: " << idle_ms << "ms" << std::endl;
+
+    std::cout << "spin = " << executor->spin() << ", wake latency: " << wake_latency(*executor, 50) << "us" << std::endl;
+
+    //休眠前先自旋, 任务间隔很短时不需要唤醒休眠的线程
+    executor->spin(1 << 14);
+    std::cout << "spin = " << executor->spin() << ", wake latency: " << wake_latency(*executor, 50) << "us" << std::endl;
+
+    //phase改变时唤醒所有休眠的任务线程, shutdown不需要等待轮询超时
+    executor->spin(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Clock::time_point start = Clock::now();
+    executor->shutdown();
+    delete executor;
+    std::cout << "shutdown and join 4 idle workers: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() << "us" << std::endl;
+    return 0;
+}
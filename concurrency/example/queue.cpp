@@ -1,12 +1,16 @@
 #include <sys/signal.h>
 #include <unistd.h>
+#include <cstdlib>
 #include <memory>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #include "stack_trace/stack_trace.hpp"
 #include "concurrency/concurrent_queue/array_blocking_queue.hpp"
 #include "concurrency/concurrent_queue/linked_blocking_queue.hpp"
+#include "concurrency/concurrent_queue/lock_free_array_queue.hpp"
+#include "concurrency/concurrent_queue/dynamic_array_blocking_queue.hpp"
 #include "concurrency/concurrent_queue/priority_blocking_queue.hpp"
 
 void handler(int)
@@ -46,6 +50,43 @@ void task_consumer()
     }
 }
 
+//多个生产者和多个消费者同时读写同一个队列, 每个元素只被取出一次
+template <typename Queue>
+bool mpmc(Queue &q, const char *name)
+{
+    const std::size_t producers = 4, consumers = 4, per_producer = 10000;
+    std::atomic<std::size_t> sum(0);
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&q, p, per_producer]() {
+            for (std::size_t i = 0; i < per_producer; i++)
+            {
+                q.push(p * per_producer + i);
+            }
+        });
+    }
+    for (std::size_t c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&q, &sum, producers, consumers, per_producer]() {
+            std::size_t local = 0;
+            for (std::size_t i = 0; i < producers * per_producer / consumers; i++)
+            {
+                local += q.pop();
+            }
+            sum += local;
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    std::size_t total = producers * per_producer;
+    bool ok = sum == total * (total - 1) / 2 && q.empty();
+    std::cout << name << " mpmc: sum = " << sum << (ok ? " ok" : " failed") << std::endl;
+    return ok;
+}
+
 int main(int argc, char const *argv[])
 {
     signal(SIGSEGV, handler);
@@ -61,5 +102,21 @@ int main(int argc, char const *argv[])
 
     // sleep(5);
 
+    //容量远小于元素数量, 生产者会在队列满时阻塞
+    LockFreeArrayQueue<std::size_t> lock_free(64);
+    if (!mpmc(lock_free, "LockFreeArrayQueue"))
+    {
+        return 1;
+    }
+
+    //容量在运行时指定, 不需要是2的幂
+    std::size_t depth = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+    DynamicArrayBlockingQueue<std::size_t> dynamic(depth);
+    std::cout << "DynamicArrayBlockingQueue cap = " << dynamic.cap() << std::endl;
+    if (dynamic.cap() != depth || !mpmc(dynamic, "DynamicArrayBlockingQueue"))
+    {
+        return 1;
+    }
+
     return 0;
 }
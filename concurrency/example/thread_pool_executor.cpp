@@ -2,6 +2,7 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "concurrency/thread/thread.hpp"
 #include "concurrency/thread/named_thread_factory.hpp"
@@ -42,6 +43,10 @@ int main(int argc, char const *argv[])
     executor->execute([]()
                       { std::cout << current_thread_name() << std::endl; });
 
+    //任务数量超过队列容量, 队列满时等待任务线程取走任务
+    std::vector<std::shared_ptr<ExecutorTask>> tasks(32, task);
+    executor->execute_bulk(tasks.begin(), tasks.end());
+
     std::this_thread::sleep_for(std::chrono::seconds(3));
     executor->shutdown();
     delete executor;
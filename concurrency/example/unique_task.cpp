@@ -0,0 +1,138 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "concurrency/thread/named_thread_factory.hpp"
+#include "concurrency/concurrent_queue/array_blocking_queue.hpp"
+#include "concurrency/executor/task_slab.hpp"
+#include "concurrency/executor/unique_task.hpp"
+#include "concurrency/executor/thread_pool_executor.hpp"
+
+class CountTask : public ExecutorTask
+{
+private:
+    std::atomic<int> &_count;
+
+public:
+    CountTask(std::atomic<int> &count) : _count(count) {}
+    virtual void run()
+    {
+        _count++;
+    }
+};
+
+//只能移动的可调用对象
+struct AddOwned
+{
+    int &x;
+    std::unique_ptr<int> value;
+    void operator()()
+    {
+        x += *value;
+    }
+};
+
+//小闭包保存在UniqueTask对象内, 大闭包从TaskSlab申请, 都只能移动
+int storage()
+{
+    int x = 0;
+    UniqueTask small([&x]()
+                     { x += 1; });
+    std::array<char, 200> payload;
+    payload.fill(1);
+    UniqueTask big([&x, payload]()
+                   { x += payload[199]; });
+    UniqueTask move_only(AddOwned{x, std::unique_ptr<int>(new int(10))});
+    std::cout << "sizeof(UniqueTask) = " << sizeof(UniqueTask) << ", small inline = " << small.is_inline()
+              << ", big inline = " << big.is_inline() << ", move only inline = " << move_only.is_inline() << std::endl;
+    if (!small.is_inline() || big.is_inline() || !move_only.is_inline())
+    {
+        return 1;
+    }
+
+    //移动后原对象为空, 堆上的闭包只移动指针
+    UniqueTask moved(std::move(big));
+    if (big || !moved || moved.is_inline())
+    {
+        return 1;
+    }
+    small();
+    moved();
+    move_only();
+    return x == 12 ? 0 : 1;
+}
+
+//释放的块放回本线程的缓存, 再次申请同一分级时复用
+int slab()
+{
+    void *p = TaskSlab::allocate(100);
+    TaskSlab::deallocate(p, 100);
+    void *q = TaskSlab::allocate(128);
+    TaskSlab::deallocate(q, 128);
+    std::cout << "slab block reused = " << (p == q) << std::endl;
+    //超过MAX_SIZE的直接使用operator new
+    void *large = TaskSlab::allocate(TaskSlab::MAX_SIZE + 1);
+    TaskSlab::deallocate(large, TaskSlab::MAX_SIZE + 1);
+    return p == q ? 0 : 1;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (storage() != 0)
+    {
+        std::cout << "storage failed" << std::endl;
+        return 1;
+    }
+    if (slab() != 0)
+    {
+        std::cout << "slab failed" << std::endl;
+        return 1;
+    }
+
+    //队列元素为UniqueTask, 闭包直接放入队列, 不需要包装成std::shared_ptr<FunctionExecutorTask>
+    using Pool = ThreadPoolExecutor<ArrayBlockingQueue<UniqueTask, 1024>>;
+    auto *executor = new Pool(4, std::make_shared<NamedThreadFactory>("unique"));
+    executor->start();
+
+    const int n = 100000;
+    std::atomic<int> count(0);
+    std::array<int, 32> weights;
+    weights.fill(1);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+    {
+        if (i % 2 == 0)
+        {
+            executor->execute([&count]()
+                              { count++; });
+        }
+        else
+        {
+            //捕获128字节, 从生产者线程的TaskSlab申请, 在任务线程释放
+            executor->execute([&count, weights]()
+                              { count += weights[31]; });
+        }
+    }
+    //ExecutorTask也可以放入UniqueTask队列
+    executor->execute(std::make_shared<CountTask>(count));
+    auto res = executor->submit([](int a, int b)
+                                { return a + b; },
+                                1, 2);
+    if (res.get() != 3)
+    {
+        return 1;
+    }
+    while (count < n + 1)
+    {
+        std::this_thread::yield();
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "run " << count << " tasks in " << us << "us" << std::endl;
+
+    executor->shutdown();
+    delete executor;
+    return 0;
+}
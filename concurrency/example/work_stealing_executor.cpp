@@ -0,0 +1,51 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "concurrency/thread/named_thread_factory.hpp"
+#include "concurrency/concurrent_queue/lock_free_array_queue.hpp"
+#include "concurrency/executor/work_stealing_executor.hpp"
+
+using Queue = LockFreeArrayQueue<std::shared_ptr<ExecutorTask>>;
+
+std::atomic<std::size_t> leaves{0};
+std::atomic<std::size_t> pending{0};
+
+//将[begin, end)不断二分, 子任务在任务线程中提交, 进入本线程的队列, 空闲线程从队列顶部窃取较大的区间
+void split(WorkStealingExecutor<Queue> *executor, std::size_t begin, std::size_t end)
+{
+    if (end - begin <= 16)
+    {
+        leaves.fetch_add(end - begin);
+        pending.fetch_sub(1);
+        return;
+    }
+    std::size_t mid = begin + (end - begin) / 2;
+    pending.fetch_add(1);
+    executor->execute([=]()
+                      { split(executor, begin, mid); });
+    split(executor, mid, end);
+}
+
+int main(int argc, char const *argv[])
+{
+    const std::size_t n = 1 << 20;
+    WorkStealingExecutor<Queue> executor(std::thread::hardware_concurrency(), std::make_shared<NamedThreadFactory>("steal"));
+    executor.start();
+
+    auto t1 = std::chrono::steady_clock::now();
+    pending.store(1);
+    executor.execute([&]()
+                     { split(&executor, 0, n); });
+    while (pending.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << "leaves=" << leaves.load() << " expect=" << n << " cost="
+              << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << "us" << std::endl;
+    executor.shutdown();
+    return 0;
+}
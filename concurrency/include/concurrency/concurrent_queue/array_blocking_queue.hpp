@@ -1,6 +1,7 @@
 #ifndef __ARRAY_BLOCKING_QUEUE_HPP__
 #define __ARRAY_BLOCKING_QUEUE_HPP__
 
+#include <atomic>
 #include <mutex>
 #include <chrono>
 #include <condition_variable>
@@ -24,7 +25,7 @@ private:
     std::condition_variable _not_empty;
     std::size_t _put_idx = 0;
     std::size_t _take_idx = 0;
-    std::size_t _count = 0;
+    std::atomic<std::size_t> _count{0};
 
 public:
     typedef T value_type;
@@ -103,6 +104,37 @@ public:
     template <class Rep, class Period>
     bool wait_pop(T &ele, const std::chrono::duration<Rep, Period> &wait_duration);
 
+    /**
+     * @brief 阻塞地将[first, last)中的元素放入队列, 每次加锁放入尽量多的元素, 队列满时等待
+     *        元素由*first赋值, 需要移动时传入std::make_move_iterator
+     *
+     * @tparam Iterator 输入迭代器
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     */
+    template <typename Iterator>
+    void push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 一次加锁放入[first, last)中尽量多的元素, 不等待队列空位
+     *
+     * @tparam Iterator 输入迭代器
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     * @return Iterator 第一个没有放入的元素
+     */
+    template <typename Iterator>
+    Iterator try_push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 一次加锁弹出最多max个元素, 不等待
+     *
+     * @tparam OutputIterator 输出迭代器
+     * @param out 弹出元素写入的位置
+     * @param max 最多弹出的数量
+     * @return std::size_t 弹出的数量
+     */
+    template <typename OutputIterator>
+    std::size_t pop_bulk(OutputIterator out, std::size_t max);
+
     /**
      * @brief 返回队列大小
      */
@@ -129,6 +161,13 @@ private:
      * @brief FIFO插入元素
      */
     void insert(const T &ele);
+    /**
+     * @brief 插入元素直到队列已满, first移动到第一个没有插入的元素
+     *
+     * @return std::size_t 插入的数量
+     */
+    template <typename Iterator>
+    std::size_t insert_bulk(Iterator &first, Iterator last);
     /**
      * @brief FIFO删除元素
      */
@@ -174,8 +213,13 @@ void ArrayBlockingQueue<T, N>::push(const T &ele)
 template <typename T, std::size_t N>
 bool ArrayBlockingQueue<T, N>::try_push(T &&ele)
 {
-    if (_mutex.try_lock() && !full())
+    if (_mutex.try_lock())
     {
+        if (full())
+        {
+            _mutex.unlock();
+            return false;
+        }
         this->insert(std::forward<T>(ele));
         _mutex.unlock();
         _not_empty.notify_one();
@@ -215,7 +259,7 @@ bool ArrayBlockingQueue<T, N>::wait_push(T &&ele, const std::chrono::duration<Re
                                  { return !full(); });
         if (res)
         {
-            this->insert(ele);
+            this->insert(std::forward<T>(ele));
             _not_empty.notify_one();
         }
     }
@@ -293,6 +337,53 @@ bool ArrayBlockingQueue<T, N>::wait_pop(T &ele, const std::chrono::duration<Rep,
     return res;
 }
 
+template <typename T, std::size_t N>
+template <typename Iterator>
+void ArrayBlockingQueue<T, N>::push_bulk(Iterator first, Iterator last)
+{
+    while (first != last)
+    {
+        std::size_t n;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _not_full.wait(lock, [this]()
+                           { return !full(); });
+            n = insert_bulk(first, last);
+        }
+        queue_detail::notify_n(_not_empty, n);
+    }
+}
+
+template <typename T, std::size_t N>
+template <typename Iterator>
+Iterator ArrayBlockingQueue<T, N>::try_push_bulk(Iterator first, Iterator last)
+{
+    std::size_t n;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        n = insert_bulk(first, last);
+    }
+    queue_detail::notify_n(_not_empty, n);
+    return first;
+}
+
+template <typename T, std::size_t N>
+template <typename OutputIterator>
+std::size_t ArrayBlockingQueue<T, N>::pop_bulk(OutputIterator out, std::size_t max)
+{
+    std::size_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (; n < max && !empty(); n++)
+        {
+            *out = remove();
+            ++out;
+        }
+    }
+    queue_detail::notify_n(_not_full, n);
+    return n;
+}
+
 template <typename T, std::size_t N>
 std::size_t ArrayBlockingQueue<T, N>::size()
 {
@@ -331,7 +422,7 @@ void ArrayBlockingQueue<T, N>::insert(T &&ele)
 template <typename T, std::size_t N>
 void ArrayBlockingQueue<T, N>::insert(const T &ele)
 {
-    _queue[_put_idx] = ele;
+    _queue[_put_idx] = queue_detail::copy_element(ele);
     if (++_put_idx == cap())
     {
         _put_idx = 0;
@@ -339,6 +430,18 @@ void ArrayBlockingQueue<T, N>::insert(const T &ele)
     _count++;
 }
 
+template <typename T, std::size_t N>
+template <typename Iterator>
+std::size_t ArrayBlockingQueue<T, N>::insert_bulk(Iterator &first, Iterator last)
+{
+    std::size_t n = 0;
+    for (; first != last && !full(); ++first, n++)
+    {
+        this->insert(*first);
+    }
+    return n;
+}
+
 template <typename T, std::size_t N>
 T ArrayBlockingQueue<T, N>::remove()
 {
@@ -2,6 +2,48 @@
 #define __CONCURRENT_QUEUE_HPP__
 
 #include <cinttypes>
+#include <stdexcept>
+#include <type_traits>
+
+//缓存行大小, 不同线程频繁修改的变量之间用它填充, 避免伪共享
+constexpr const std::size_t CACHE_LINE_SIZE = 64;
+
+namespace queue_detail
+{
+    template <typename T>
+    T copy_element(const T &ele, std::true_type)
+    {
+        return ele;
+    }
+
+    template <typename T>
+    T copy_element(const T &, std::false_type)
+    {
+        throw std::runtime_error("queue element type is move only");
+    }
+
+    /**
+     * @brief 复制元素, 元素只能移动(如UniqueTask)时抛出异常
+     *        队列的push(const T &)等是虚函数, 队列实例化时一定会实例化, 所以不能直接复制
+     */
+    template <typename T>
+    T copy_element(const T &ele)
+    {
+        return copy_element(ele, std::is_copy_constructible<T>());
+    }
+
+    /**
+     * @brief 批量放入或取出n个元素后唤醒最多n个等待者, 没有等待者时notify_one不会进入内核
+     */
+    template <typename Cond>
+    void notify_n(Cond &cond, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            cond.notify_one();
+        }
+    }
+}
 
 //FIFO队列
 template <typename T>
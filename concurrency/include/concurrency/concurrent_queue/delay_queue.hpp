@@ -82,6 +82,15 @@ public:
 
     template <class Rep, class Period>
     bool wait_pop(T &ele, const std::chrono::duration<Rep, Period> &wait_duration);
+    /**
+     * @brief 取出已经到期的队首元素, 不等待
+     *
+     * @param ele 弹出元素赋值对象
+     * @param next 没有到期的元素时为队首元素的到期时间, 队列为空时为time_point::max()
+     * @return true 取出成功
+     * @return false 队列为空或队首元素还没有到期
+     */
+    bool poll(T &ele, time_point &next);
 
     template <class Rep, class Period>
     void push(const std::chrono::duration<Rep, Period> &delay, T &&ele);
@@ -308,6 +317,25 @@ bool DelayQueue<T, Clock>::wait_pop(T &ele, const std::chrono::duration<Rep, Per
     return false;
 }
 
+template <typename T, typename Clock>
+bool DelayQueue<T, Clock>::poll(T &ele, time_point &next)
+{
+    std::lock_guard<std::timed_mutex> lock(_mutex);
+    if (_queue.empty())
+    {
+        next = time_point::max();
+        return false;
+    }
+    next = _queue.top().second;
+    if (next > Clock::now())
+    {
+        return false;
+    }
+    ele = _queue.top().first;
+    _queue.pop();
+    return true;
+}
+
 template <typename T, typename Clock>
 template <class Rep, class Period>
 void DelayQueue<T, Clock>::push(const std::chrono::duration<Rep, Period> &delay, T &&ele)
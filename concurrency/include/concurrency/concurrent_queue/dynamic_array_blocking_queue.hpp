@@ -0,0 +1,616 @@
+#ifndef __DYNAMIC_ARRAY_BLOCKING_QUEUE_HPP__
+#define __DYNAMIC_ARRAY_BLOCKING_QUEUE_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "concurrency/concurrent_queue/concurrent_queue.hpp"
+
+/**
+ * @brief 运行时指定容量的数组队列, 内存由分配器申请, 数组大小为2的幂, 用位与代替取模
+ *        入队和出队使用不同的锁(与LinkedBlockingQueue相同), put index和take index在不同的缓存行
+ *        元素在入队时构造, 出队时析构, 不需要默认构造函数, try_pop和wait_pop需要移动赋值
+ *
+ * @tparam T 元素种类
+ * @tparam Alloc 分配器
+ */
+template <typename T, typename Alloc = std::allocator<T>>
+class DynamicArrayBlockingQueue
+{
+private:
+    typedef std::allocator_traits<Alloc> AllocTraits;
+
+    const std::size_t _cap;
+    //数组大小为不小于_cap的2的幂, 队列最多只使用_cap个位置
+    const std::size_t _mask;
+    Alloc _allocator;
+    T *_queue;
+    char _pad0[CACHE_LINE_SIZE];
+    std::mutex _put_mutex;
+    std::condition_variable _not_full;
+    //只增加的下标, 元素位置为_put_idx & _mask
+    std::atomic<std::size_t> _put_idx{0};
+    char _pad1[CACHE_LINE_SIZE];
+    std::mutex _take_mutex;
+    std::condition_variable _not_empty;
+    std::atomic<std::size_t> _take_idx{0};
+    char _pad2[CACHE_LINE_SIZE];
+
+public:
+    typedef T value_type;
+    /**
+     * @brief 构造函数
+     * @param cap 最大容量
+     * @param a 分配器
+     */
+    explicit DynamicArrayBlockingQueue(std::size_t cap = 1024, const Alloc &a = Alloc());
+    virtual ~DynamicArrayBlockingQueue();
+    DynamicArrayBlockingQueue(const DynamicArrayBlockingQueue &) = delete;
+    DynamicArrayBlockingQueue &operator=(const DynamicArrayBlockingQueue &) = delete;
+    /**
+     * @brief 阻塞地将元素的放入队列
+     */
+    virtual void push(T &&ele);
+    /**
+     * @brief 阻塞地将元素的放入队列
+     */
+    virtual void push(const T &ele);
+    /**
+     * @brief 将元素的放入队列, 立即返回
+     * @param T 入队元素
+     * @return bool 入队是否成功
+     */
+    virtual bool try_push(T &&ele);
+    /**
+     * @brief 将元素的放入队列, 立即返回
+     * @param T 入队元素
+     * @return bool 入队是否成功
+     */
+    virtual bool try_push(const T &ele);
+
+    /**
+     * @brief 等待地将元素放进队列
+     *
+     * @tparam Rep 刻度数的算术类型
+     * @tparam Period 滴答周期
+     * @param ele 入队元素
+     * @param wait_duration 等待时间
+     * @return true 入队成功
+     * @return false 入队失败
+     */
+    template <class Rep, class Period>
+    bool wait_push(T &&ele, const std::chrono::duration<Rep, Period> &wait_duration);
+
+    /**
+     * @brief 等待地将元素放进队列
+     *
+     * @tparam Rep 刻度数的算术类型
+     * @tparam Period 滴答周期
+     * @param ele 入队元素
+     * @param wait_duration 等待时间
+     * @return true 入队成功
+     * @return false 入队失败
+     */
+    template <class Rep, class Period>
+    bool wait_push(const T &ele, const std::chrono::duration<Rep, Period> &wait_duration);
+
+    /**
+     * @brief 将元素弹出队列
+     */
+    virtual T pop();
+    /**
+     * @brief try_pop 弹出队列元素, 立即返回
+     *
+     * @param ele 弹出元素赋值对象
+     */
+    virtual bool try_pop(T &ele);
+
+    /**
+     * @brief 等待地将元素弹出队列
+     *
+     * @tparam Rep 刻度数的算术类型
+     * @tparam Period 滴答周期
+     * @param ele 弹出元素赋值对象
+     * @param wait_duration 等待时间
+     * @return true 出队成功
+     * @return false 出队失败
+     */
+    template <class Rep, class Period>
+    bool wait_pop(T &ele, const std::chrono::duration<Rep, Period> &wait_duration);
+
+    /**
+     * @brief 阻塞地将[first, last)中的元素放入队列, 每次加锁放入尽量多的元素, 队列满时等待
+     *        元素由*first构造, 需要移动时传入std::make_move_iterator
+     *
+     * @tparam Iterator 输入迭代器
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     */
+    template <typename Iterator>
+    void push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 一次加锁放入[first, last)中尽量多的元素, 不等待队列空位
+     *
+     * @tparam Iterator 输入迭代器
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     * @return Iterator 第一个没有放入的元素
+     */
+    template <typename Iterator>
+    Iterator try_push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 一次加锁弹出最多max个元素, 不等待
+     *
+     * @tparam OutputIterator 输出迭代器
+     * @param out 弹出元素写入的位置
+     * @param max 最多弹出的数量
+     * @return std::size_t 弹出的数量
+     */
+    template <typename OutputIterator>
+    std::size_t pop_bulk(OutputIterator out, std::size_t max);
+
+    /**
+     * @brief 返回队列大小
+     */
+    virtual std::size_t size();
+    /**
+     * @brief 返回队列容量
+     */
+    virtual std::size_t cap();
+    /**
+     * @brief 队列是否为空
+     */
+    virtual bool empty();
+
+private:
+    static std::size_t round_up(std::size_t cap);
+    /**
+     * @brief 队列已满, 持有_put_mutex时调用
+     */
+    bool full();
+    /**
+     * @brief FIFO插入元素, 持有_put_mutex时调用
+     *
+     * @return std::size_t 插入前的元素数量
+     */
+    template <typename U>
+    std::size_t insert(U &&ele);
+    /**
+     * @brief FIFO删除元素, 持有_take_mutex时调用
+     *
+     * @param count 删除前的元素数量
+     * @return T 从队列中移动构造的元素
+     */
+    T remove(std::size_t &count);
+    /**
+     * @brief 插入元素直到队列已满, 只修改一次_put_idx, 持有_put_mutex时调用
+     *
+     * @param first 插入后移动到第一个没有插入的元素
+     * @param n 插入的数量
+     * @return std::size_t 插入前的元素数量
+     */
+    template <typename Iterator>
+    std::size_t insert_bulk(Iterator &first, Iterator last, std::size_t &n);
+    /**
+     * @brief 删除最多max个元素, 只修改一次_take_idx, 持有_take_mutex时调用
+     *
+     * @param n 删除的数量
+     * @return std::size_t 删除前的元素数量
+     */
+    template <typename OutputIterator>
+    std::size_t remove_bulk(OutputIterator &out, std::size_t max, std::size_t &n);
+    /**
+     * @brief 入队前队列为空时唤醒n个出队线程, 加锁保证不会在出队线程检查条件之后开始等待之前通知
+     */
+    void signal_not_empty(std::size_t n = 1);
+    /**
+     * @brief 出队前队列已满时唤醒n个入队线程
+     */
+    void signal_not_full(std::size_t n = 1);
+};
+
+template <typename T, typename Alloc>
+std::size_t DynamicArrayBlockingQueue<T, Alloc>::round_up(std::size_t cap)
+{
+    std::size_t res = 1;
+    while (res < cap)
+    {
+        res <<= 1;
+    }
+    return res;
+}
+
+template <typename T, typename Alloc>
+DynamicArrayBlockingQueue<T, Alloc>::DynamicArrayBlockingQueue(std::size_t cap, const Alloc &a)
+    : _cap(cap == 0 ? 1 : cap), _mask(round_up(_cap) - 1), _allocator(a)
+{
+    _queue = AllocTraits::allocate(_allocator, _mask + 1);
+}
+
+template <typename T, typename Alloc>
+DynamicArrayBlockingQueue<T, Alloc>::~DynamicArrayBlockingQueue()
+{
+    for (std::size_t i = _take_idx.load(); i != _put_idx.load(); i++)
+    {
+        AllocTraits::destroy(_allocator, _queue + (i & _mask));
+    }
+    AllocTraits::deallocate(_allocator, _queue, _mask + 1);
+}
+
+template <typename T, typename Alloc>
+void DynamicArrayBlockingQueue<T, Alloc>::push(T &&ele)
+{
+    std::size_t count;
+    {
+        std::unique_lock<std::mutex> lock(_put_mutex);
+        _not_full.wait(lock, [this]()
+                       { return !full(); });
+        count = this->insert(std::move(ele));
+    }
+    if (count == 0)
+    {
+        signal_not_empty();
+    }
+}
+
+template <typename T, typename Alloc>
+void DynamicArrayBlockingQueue<T, Alloc>::push(const T &ele)
+{
+    std::size_t count;
+    {
+        std::unique_lock<std::mutex> lock(_put_mutex);
+        _not_full.wait(lock, [this]()
+                       { return !full(); });
+        count = this->insert(queue_detail::copy_element(ele));
+    }
+    if (count == 0)
+    {
+        signal_not_empty();
+    }
+}
+
+template <typename T, typename Alloc>
+bool DynamicArrayBlockingQueue<T, Alloc>::try_push(T &&ele)
+{
+    std::size_t count;
+    {
+        std::lock_guard<std::mutex> lock(_put_mutex);
+        if (full())
+        {
+            return false;
+        }
+        count = this->insert(std::move(ele));
+    }
+    if (count == 0)
+    {
+        signal_not_empty();
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+bool DynamicArrayBlockingQueue<T, Alloc>::try_push(const T &ele)
+{
+    std::size_t count;
+    {
+        std::lock_guard<std::mutex> lock(_put_mutex);
+        if (full())
+        {
+            return false;
+        }
+        count = this->insert(queue_detail::copy_element(ele));
+    }
+    if (count == 0)
+    {
+        signal_not_empty();
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+template <class Rep, class Period>
+bool DynamicArrayBlockingQueue<T, Alloc>::wait_push(T &&ele, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    std::size_t count;
+    {
+        std::unique_lock<std::mutex> lock(_put_mutex);
+        if (!_not_full.wait_for(lock, wait_duration, [this]()
+                                { return !full(); }))
+        {
+            return false;
+        }
+        count = this->insert(std::move(ele));
+    }
+    if (count == 0)
+    {
+        signal_not_empty();
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+template <class Rep, class Period>
+bool DynamicArrayBlockingQueue<T, Alloc>::wait_push(const T &ele, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    std::size_t count;
+    {
+        std::unique_lock<std::mutex> lock(_put_mutex);
+        if (!_not_full.wait_for(lock, wait_duration, [this]()
+                                { return !full(); }))
+        {
+            return false;
+        }
+        count = this->insert(queue_detail::copy_element(ele));
+    }
+    if (count == 0)
+    {
+        signal_not_empty();
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+T DynamicArrayBlockingQueue<T, Alloc>::pop()
+{
+    std::size_t count;
+    std::unique_lock<std::mutex> lock(_take_mutex);
+    _not_empty.wait(lock, [this]()
+                    { return !empty(); });
+    T ele = remove(count);
+    lock.unlock();
+    if (count == _cap)
+    {
+        signal_not_full();
+    }
+    return ele;
+}
+
+template <typename T, typename Alloc>
+bool DynamicArrayBlockingQueue<T, Alloc>::try_pop(T &ele)
+{
+    std::size_t count;
+    {
+        std::lock_guard<std::mutex> lock(_take_mutex);
+        if (empty())
+        {
+            return false;
+        }
+        ele = remove(count);
+    }
+    if (count == _cap)
+    {
+        signal_not_full();
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+template <class Rep, class Period>
+bool DynamicArrayBlockingQueue<T, Alloc>::wait_pop(T &ele, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    std::size_t count;
+    {
+        std::unique_lock<std::mutex> lock(_take_mutex);
+        if (!_not_empty.wait_for(lock, wait_duration, [this]()
+                                 { return !empty(); }))
+        {
+            return false;
+        }
+        ele = remove(count);
+    }
+    if (count == _cap)
+    {
+        signal_not_full();
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+template <typename Iterator>
+void DynamicArrayBlockingQueue<T, Alloc>::push_bulk(Iterator first, Iterator last)
+{
+    while (first != last)
+    {
+        std::size_t count;
+        std::size_t n;
+        {
+            std::unique_lock<std::mutex> lock(_put_mutex);
+            _not_full.wait(lock, [this]()
+                           { return !full(); });
+            count = insert_bulk(first, last, n);
+        }
+        if (count == 0)
+        {
+            signal_not_empty(n);
+        }
+    }
+}
+
+template <typename T, typename Alloc>
+template <typename Iterator>
+Iterator DynamicArrayBlockingQueue<T, Alloc>::try_push_bulk(Iterator first, Iterator last)
+{
+    std::size_t count;
+    std::size_t n;
+    {
+        std::lock_guard<std::mutex> lock(_put_mutex);
+        if (first == last || full())
+        {
+            return first;
+        }
+        count = insert_bulk(first, last, n);
+    }
+    if (count == 0)
+    {
+        signal_not_empty(n);
+    }
+    return first;
+}
+
+template <typename T, typename Alloc>
+template <typename OutputIterator>
+std::size_t DynamicArrayBlockingQueue<T, Alloc>::pop_bulk(OutputIterator out, std::size_t max)
+{
+    std::size_t count;
+    std::size_t n;
+    {
+        std::lock_guard<std::mutex> lock(_take_mutex);
+        if (max == 0 || empty())
+        {
+            return 0;
+        }
+        count = remove_bulk(out, max, n);
+    }
+    if (count == _cap)
+    {
+        signal_not_full(n);
+    }
+    return n;
+}
+
+template <typename T, typename Alloc>
+std::size_t DynamicArrayBlockingQueue<T, Alloc>::size()
+{
+    std::size_t take = _take_idx.load(std::memory_order_acquire);
+    return _put_idx.load(std::memory_order_acquire) - take;
+}
+
+template <typename T, typename Alloc>
+std::size_t DynamicArrayBlockingQueue<T, Alloc>::cap()
+{
+    return _cap;
+}
+
+template <typename T, typename Alloc>
+bool DynamicArrayBlockingQueue<T, Alloc>::empty()
+{
+    return _take_idx.load(std::memory_order_relaxed) == _put_idx.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Alloc>
+bool DynamicArrayBlockingQueue<T, Alloc>::full()
+{
+    return _put_idx.load(std::memory_order_relaxed) - _take_idx.load(std::memory_order_acquire) == _cap;
+}
+
+template <typename T, typename Alloc>
+template <typename U>
+std::size_t DynamicArrayBlockingQueue<T, Alloc>::insert(U &&ele)
+{
+    std::size_t put = _put_idx.load(std::memory_order_relaxed);
+    AllocTraits::construct(_allocator, _queue + (put & _mask), std::forward<U>(ele));
+    //先修改自己的下标再读取对方的下标, 都使用seq_cst, 与remove同时执行时至少有一方能看到对方的修改,
+    //不会出现双方都认为不需要唤醒的情况
+    _put_idx.store(put + 1);
+    std::size_t count = put - _take_idx.load();
+    //还有空位时唤醒下一个等待的入队线程, 出队线程只在队列从满变为不满时唤醒一个
+    if (count + 1 < _cap)
+    {
+        _not_full.notify_one();
+    }
+    return count;
+}
+
+template <typename T, typename Alloc>
+T DynamicArrayBlockingQueue<T, Alloc>::remove(std::size_t &count)
+{
+    std::size_t take = _take_idx.load(std::memory_order_relaxed);
+    T *p = _queue + (take & _mask);
+    T ele(std::move(*p));
+    AllocTraits::destroy(_allocator, p);
+    _take_idx.store(take + 1);
+    count = _put_idx.load() - take;
+    //还有元素时唤醒下一个等待的出队线程
+    if (count > 1)
+    {
+        _not_empty.notify_one();
+    }
+    return ele;
+}
+
+template <typename T, typename Alloc>
+template <typename Iterator>
+std::size_t DynamicArrayBlockingQueue<T, Alloc>::insert_bulk(Iterator &first, Iterator last, std::size_t &n)
+{
+    std::size_t put = _put_idx.load(std::memory_order_relaxed);
+    std::size_t space = _cap - (put - _take_idx.load(std::memory_order_acquire));
+    n = 0;
+    try
+    {
+        for (; first != last && n < space; ++first, n++)
+        {
+            AllocTraits::construct(_allocator, _queue + ((put + n) & _mask), *first);
+        }
+    }
+    catch (...)
+    {
+        //已经构造的元素仍然放入队列
+        _put_idx.store(put + n);
+        throw;
+    }
+    //与insert相同, 先修改自己的下标再读取对方的下标
+    _put_idx.store(put + n);
+    std::size_t count = put - _take_idx.load();
+    if (count + n < _cap)
+    {
+        _not_full.notify_one();
+    }
+    return count;
+}
+
+template <typename T, typename Alloc>
+template <typename OutputIterator>
+std::size_t DynamicArrayBlockingQueue<T, Alloc>::remove_bulk(OutputIterator &out, std::size_t max, std::size_t &n)
+{
+    std::size_t take = _take_idx.load(std::memory_order_relaxed);
+    std::size_t size = _put_idx.load(std::memory_order_acquire) - take;
+    std::size_t i = 0;
+    n = std::min(size, max);
+    try
+    {
+        for (; i < n; i++)
+        {
+            T *p = _queue + ((take + i) & _mask);
+            *out = std::move(*p);
+            ++out;
+            AllocTraits::destroy(_allocator, p);
+        }
+    }
+    catch (...)
+    {
+        //已经析构的元素必须移出队列
+        _take_idx.store(take + i);
+        throw;
+    }
+    _take_idx.store(take + n);
+    std::size_t count = _put_idx.load() - take;
+    if (count > n)
+    {
+        _not_empty.notify_one();
+    }
+    return count;
+}
+
+template <typename T, typename Alloc>
+void DynamicArrayBlockingQueue<T, Alloc>::signal_not_empty(std::size_t n)
+{
+    {
+        std::lock_guard<std::mutex> lock(_take_mutex);
+    }
+    queue_detail::notify_n(_not_empty, n);
+}
+
+template <typename T, typename Alloc>
+void DynamicArrayBlockingQueue<T, Alloc>::signal_not_full(std::size_t n)
+{
+    {
+        std::lock_guard<std::mutex> lock(_put_mutex);
+    }
+    queue_detail::notify_n(_not_full, n);
+}
+
+#endif /* __DYNAMIC_ARRAY_BLOCKING_QUEUE_HPP__ */
@@ -35,6 +35,7 @@ private:
     std::atomic<::size_t> _count{0};
 
 public:
+    typedef T value_type;
     /**
      * @brief 构造函数
      * @param cap 最大容量
@@ -91,6 +92,36 @@ public:
      * @param value 弹出元素赋值对象
      */
     virtual bool wait_pop(T &value, std::size_t seconds, std::size_t nano_seconds = 0);
+    /**
+     * @brief 阻塞地将[first, last)中的元素放入队列, 每次加锁放入尽量多的元素, 队列满时等待
+     *        元素由*first构造, 需要移动时传入std::make_move_iterator
+     *
+     * @tparam Iterator 输入迭代器
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     */
+    template <typename Iterator>
+    void push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 一次加锁放入[first, last)中尽量多的元素, 不等待队列空位
+     *
+     * @tparam Iterator 输入迭代器
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     * @return Iterator 第一个没有放入的元素
+     */
+    template <typename Iterator>
+    Iterator try_push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 一次加锁弹出最多max个元素, 不等待
+     *
+     * @tparam OutputIterator 输出迭代器
+     * @param out 弹出元素写入的位置
+     * @param max 最多弹出的数量
+     * @return std::size_t 弹出的数量
+     */
+    template <typename OutputIterator>
+    std::size_t pop_bulk(OutputIterator out, std::size_t max);
     /**
      * @brief 返回队列大小
      */
@@ -117,6 +148,13 @@ private:
      * @brief FIFO插入元素
      */
     void insert(const T &ele);
+    /**
+     * @brief 插入元素直到队列已满, first移动到第一个没有插入的元素
+     *
+     * @return std::size_t 插入的数量
+     */
+    template <typename Iterator>
+    std::size_t insert_bulk(Iterator &first, Iterator last);
     /**
      * @brief FIFO删除元素
      */
@@ -171,8 +209,13 @@ void LinkedBlockingQueue<T>::push(const T &ele)
 template <typename T>
 bool LinkedBlockingQueue<T>::try_push(T &&ele)
 {
-    if (_put_mutex.try_lock() && !full())
+    if (_put_mutex.try_lock())
     {
+        if (full())
+        {
+            _put_mutex.unlock();
+            return false;
+        }
         this->insert(std::forward<T>(ele));
         _put_mutex.unlock();
         _not_empty.notify_one();
@@ -290,6 +333,53 @@ bool LinkedBlockingQueue<T>::wait_pop(T &ele, std::size_t seconds, std::size_t n
     return res;
 }
 
+template <typename T>
+template <typename Iterator>
+void LinkedBlockingQueue<T>::push_bulk(Iterator first, Iterator last)
+{
+    while (first != last)
+    {
+        std::size_t n;
+        {
+            std::unique_lock<std::mutex> lock(_put_mutex);
+            _not_full.wait(lock, [this]()
+                           { return !full(); });
+            n = insert_bulk(first, last);
+        }
+        queue_detail::notify_n(_not_empty, n);
+    }
+}
+
+template <typename T>
+template <typename Iterator>
+Iterator LinkedBlockingQueue<T>::try_push_bulk(Iterator first, Iterator last)
+{
+    std::size_t n;
+    {
+        std::lock_guard<std::mutex> lock(_put_mutex);
+        n = insert_bulk(first, last);
+    }
+    queue_detail::notify_n(_not_empty, n);
+    return first;
+}
+
+template <typename T>
+template <typename OutputIterator>
+std::size_t LinkedBlockingQueue<T>::pop_bulk(OutputIterator out, std::size_t max)
+{
+    std::size_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(_take_mutex);
+        for (; n < max && !empty(); n++)
+        {
+            *out = remove();
+            ++out;
+        }
+    }
+    queue_detail::notify_n(_not_full, n);
+    return n;
+}
+
 template <typename T>
 std::size_t LinkedBlockingQueue<T>::size()
 {
@@ -326,12 +416,24 @@ void LinkedBlockingQueue<T>::insert(T &&ele)
 template <typename T>
 void LinkedBlockingQueue<T>::insert(const T &ele)
 {
-    Node *node = new Node(ele);
+    Node *node = new Node(queue_detail::copy_element(ele));
     _tail->next = node;
     _tail = _tail->next;
     _count++;
 }
 
+template <typename T>
+template <typename Iterator>
+std::size_t LinkedBlockingQueue<T>::insert_bulk(Iterator &first, Iterator last)
+{
+    std::size_t n = 0;
+    for (; first != last && !full(); ++first, n++)
+    {
+        this->insert(*first);
+    }
+    return n;
+}
+
 template <typename T>
 T LinkedBlockingQueue<T>::remove()
 {
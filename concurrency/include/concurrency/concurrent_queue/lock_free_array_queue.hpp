@@ -0,0 +1,414 @@
+#ifndef __LOCK_FREE_ARRAY_QUEUE_HPP__
+#define __LOCK_FREE_ARRAY_QUEUE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "concurrency/concurrent_queue/concurrent_queue.hpp"
+
+/**
+ * @brief 有界无锁多生产者多消费者队列, 每个槽位带有序号(Vyukov), 入队和出队各只需要一次CAS
+ *        try_push/try_pop不会阻塞, push/pop/wait_push/wait_pop在队列满或空时才使用条件变量等待,
+ *        接口与ArrayBlockingQueue相同, 可以作为ThreadPoolExecutor的任务队列
+ *
+ * @tparam T 元素类型
+ */
+template <typename T>
+class LockFreeArrayQueue
+{
+private:
+    struct Slot
+    {
+        //等于put index时可写入, 等于put index + 1时可读取
+        std::atomic<std::size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    const std::size_t _cap;
+    const std::size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    char _pad0[CACHE_LINE_SIZE];
+    std::atomic<std::size_t> _put_idx{0};
+    char _pad1[CACHE_LINE_SIZE];
+    std::atomic<std::size_t> _take_idx{0};
+    char _pad2[CACHE_LINE_SIZE];
+    //只在队列满或空需要等待时使用
+    std::mutex _mutex;
+    std::condition_variable _not_full;
+    std::condition_variable _not_empty;
+    std::atomic<std::size_t> _put_waiters{0};
+    std::atomic<std::size_t> _take_waiters{0};
+
+public:
+    typedef T value_type;
+    /**
+     * @brief 构造函数
+     * @param cap 最大容量, 向上取整为2的幂
+     */
+    LockFreeArrayQueue(std::size_t cap = 1024);
+    virtual ~LockFreeArrayQueue();
+    LockFreeArrayQueue(const LockFreeArrayQueue &) = delete;
+    LockFreeArrayQueue &operator=(const LockFreeArrayQueue &) = delete;
+    /**
+     * @brief 阻塞地将元素的放入队列
+     */
+    virtual void push(T &&ele);
+    /**
+     * @brief 阻塞地将元素的放入队列
+     */
+    virtual void push(const T &ele);
+    /**
+     * @brief 将元素的放入队列, 立即返回
+     * @param T 入队元素, 入队失败时不会被移动
+     * @return bool 入队是否成功
+     */
+    virtual bool try_push(T &&ele);
+    /**
+     * @brief 将元素的放入队列, 立即返回
+     * @param T 入队元素
+     * @return bool 入队是否成功
+     */
+    virtual bool try_push(const T &ele);
+
+    /**
+     * @brief 等待地将元素放进队列
+     *
+     * @tparam Rep 刻度数的算术类型
+     * @tparam Period 滴答周期
+     * @param ele 入队元素
+     * @param wait_duration 等待时间
+     * @return true 入队成功
+     * @return false 入队失败
+     */
+    template <class Rep, class Period>
+    bool wait_push(T &&ele, const std::chrono::duration<Rep, Period> &wait_duration);
+
+    /**
+     * @brief 等待地将元素放进队列
+     *
+     * @tparam Rep 刻度数的算术类型
+     * @tparam Period 滴答周期
+     * @param ele 入队元素
+     * @param wait_duration 等待时间
+     * @return true 入队成功
+     * @return false 入队失败
+     */
+    template <class Rep, class Period>
+    bool wait_push(const T &ele, const std::chrono::duration<Rep, Period> &wait_duration);
+
+    /**
+     * @brief 将元素弹出队列
+     */
+    virtual T pop();
+    /**
+     * @brief try_pop 弹出队列元素, 立即返回
+     *
+     * @param ele 弹出元素赋值对象
+     */
+    virtual bool try_pop(T &ele);
+
+    /**
+     * @brief 等待地将元素弹出队列
+     *
+     * @tparam Rep 刻度数的算术类型
+     * @tparam Period 滴答周期
+     * @param ele 弹出元素赋值对象
+     * @param wait_duration 等待时间
+     * @return true 出队成功
+     * @return false 出队失败
+     */
+    template <class Rep, class Period>
+    bool wait_pop(T &ele, const std::chrono::duration<Rep, Period> &wait_duration);
+
+    /**
+     * @brief 返回队列大小, 并发修改时是近似值
+     */
+    virtual std::size_t size();
+    /**
+     * @brief 返回队列容量
+     */
+    virtual std::size_t cap();
+    /**
+     * @brief 队列是否为空, 并发修改时是近似值
+     */
+    virtual bool empty();
+
+private:
+    static std::size_t round_up(std::size_t cap);
+    /**
+     * @brief 无锁入队, 失败时不会构造元素
+     */
+    template <typename U>
+    bool enqueue(U &&ele);
+    /**
+     * @brief 无锁出队
+     */
+    bool dequeue(T &ele);
+    /**
+     * @brief 有线程在cond上等待时唤醒一个, 先加锁保证等待线程检查条件和开始等待之间不会丢失通知
+     */
+    void notify(std::condition_variable &cond, std::atomic<std::size_t> &waiters);
+};
+
+template <typename T>
+std::size_t LockFreeArrayQueue<T>::round_up(std::size_t cap)
+{
+    std::size_t res = 2;
+    while (res < cap)
+    {
+        res <<= 1;
+    }
+    return res;
+}
+
+template <typename T>
+LockFreeArrayQueue<T>::LockFreeArrayQueue(std::size_t cap)
+    : _cap(round_up(cap)), _mask(_cap - 1), _slots(new Slot[_cap])
+{
+    for (std::size_t i = 0; i < _cap; i++)
+    {
+        _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+LockFreeArrayQueue<T>::~LockFreeArrayQueue()
+{
+    T ele;
+    while (dequeue(ele))
+    {
+    }
+}
+
+template <typename T>
+template <typename U>
+bool LockFreeArrayQueue<T>::enqueue(U &&ele)
+{
+    std::size_t pos = _put_idx.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+        slot = &_slots[pos & _mask];
+        std::size_t seq = slot->seq.load(std::memory_order_acquire);
+        std::intptr_t diff = (std::intptr_t)seq - (std::intptr_t)pos;
+        if (diff == 0)
+        {
+            if (_put_idx.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            //槽位上一轮的元素还没有被取走, 队列已满
+            return false;
+        }
+        else
+        {
+            pos = _put_idx.load(std::memory_order_relaxed);
+        }
+    }
+    new (&slot->storage) T(std::forward<U>(ele));
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool LockFreeArrayQueue<T>::dequeue(T &ele)
+{
+    std::size_t pos = _take_idx.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+        slot = &_slots[pos & _mask];
+        std::size_t seq = slot->seq.load(std::memory_order_acquire);
+        std::intptr_t diff = (std::intptr_t)seq - (std::intptr_t)(pos + 1);
+        if (diff == 0)
+        {
+            if (_take_idx.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            //槽位还没有写入, 队列为空
+            return false;
+        }
+        else
+        {
+            pos = _take_idx.load(std::memory_order_relaxed);
+        }
+    }
+    T *p = reinterpret_cast<T *>(&slot->storage);
+    ele = std::move(*p);
+    p->~T();
+    //下一轮的put index
+    slot->seq.store(pos + _cap, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+void LockFreeArrayQueue<T>::notify(std::condition_variable &cond, std::atomic<std::size_t> &waiters)
+{
+    //与等待线程增加waiters之后再检查队列的顺序配对, 两边至少有一边能看到对方的修改
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) != 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+        }
+        cond.notify_one();
+    }
+}
+
+template <typename T>
+void LockFreeArrayQueue<T>::push(T &&ele)
+{
+    if (!enqueue(std::move(ele)))
+    {
+        _put_waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _not_full.wait(lock, [&]()
+                           { return enqueue(std::move(ele)); });
+        }
+        _put_waiters.fetch_sub(1);
+    }
+    notify(_not_empty, _take_waiters);
+}
+
+template <typename T>
+void LockFreeArrayQueue<T>::push(const T &ele)
+{
+    push(queue_detail::copy_element(ele));
+}
+
+template <typename T>
+bool LockFreeArrayQueue<T>::try_push(T &&ele)
+{
+    if (!enqueue(std::move(ele)))
+    {
+        return false;
+    }
+    notify(_not_empty, _take_waiters);
+    return true;
+}
+
+template <typename T>
+bool LockFreeArrayQueue<T>::try_push(const T &ele)
+{
+    return try_push(queue_detail::copy_element(ele));
+}
+
+template <typename T>
+template <class Rep, class Period>
+bool LockFreeArrayQueue<T>::wait_push(T &&ele, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    bool res = enqueue(std::move(ele));
+    if (!res)
+    {
+        _put_waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            res = _not_full.wait_for(lock, wait_duration, [&]()
+                                     { return enqueue(std::move(ele)); });
+        }
+        _put_waiters.fetch_sub(1);
+    }
+    if (res)
+    {
+        notify(_not_empty, _take_waiters);
+    }
+    return res;
+}
+
+template <typename T>
+template <class Rep, class Period>
+bool LockFreeArrayQueue<T>::wait_push(const T &ele, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    return wait_push(queue_detail::copy_element(ele), wait_duration);
+}
+
+template <typename T>
+T LockFreeArrayQueue<T>::pop()
+{
+    T ele;
+    if (!dequeue(ele))
+    {
+        _take_waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _not_empty.wait(lock, [&]()
+                            { return dequeue(ele); });
+        }
+        _take_waiters.fetch_sub(1);
+    }
+    notify(_not_full, _put_waiters);
+    return ele;
+}
+
+template <typename T>
+bool LockFreeArrayQueue<T>::try_pop(T &ele)
+{
+    if (!dequeue(ele))
+    {
+        return false;
+    }
+    notify(_not_full, _put_waiters);
+    return true;
+}
+
+template <typename T>
+template <class Rep, class Period>
+bool LockFreeArrayQueue<T>::wait_pop(T &ele, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    bool res = dequeue(ele);
+    if (!res)
+    {
+        _take_waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            res = _not_empty.wait_for(lock, wait_duration, [&]()
+                                      { return dequeue(ele); });
+        }
+        _take_waiters.fetch_sub(1);
+    }
+    if (res)
+    {
+        notify(_not_full, _put_waiters);
+    }
+    return res;
+}
+
+template <typename T>
+std::size_t LockFreeArrayQueue<T>::size()
+{
+    std::size_t take = _take_idx.load(std::memory_order_relaxed);
+    std::size_t put = _put_idx.load(std::memory_order_relaxed);
+    return put > take ? put - take : 0;
+}
+
+template <typename T>
+std::size_t LockFreeArrayQueue<T>::cap()
+{
+    return _cap;
+}
+
+template <typename T>
+bool LockFreeArrayQueue<T>::empty()
+{
+    return size() == 0;
+}
+
+#endif /* __LOCK_FREE_ARRAY_QUEUE_HPP__ */
@@ -98,6 +98,34 @@ public:
     template <class Rep, class Period>
     bool wait_pop(T &ele, const std::chrono::duration<Rep, Period> &wait_duration);
 
+    /**
+     * @brief 一次加锁将[first, last)中的元素全部放入队列
+     *        元素由*first构造, 需要移动时传入std::make_move_iterator
+     *
+     * @tparam Iterator 输入迭代器
+     * @param first 第一个元素
+     * @param last 最后一个元素之后
+     */
+    template <typename Iterator>
+    void push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 队列无界, 与push_bulk相同
+     *
+     * @return Iterator last
+     */
+    template <typename Iterator>
+    Iterator try_push_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 一次加锁按优先级弹出最多max个元素, 不等待
+     *
+     * @tparam OutputIterator 输出迭代器
+     * @param out 弹出元素写入的位置
+     * @param max 最多弹出的数量
+     * @return std::size_t 弹出的数量
+     */
+    template <typename OutputIterator>
+    std::size_t pop_bulk(OutputIterator out, std::size_t max);
+
     /**
      * @brief 返回队列大小
      */
@@ -255,6 +283,43 @@ bool PriorityBlockingQueue<T, Compare>::wait_pop(T &ele, const std::chrono::dura
     }
 }
 
+template <typename T, typename Compare>
+template <typename Iterator>
+void PriorityBlockingQueue<T, Compare>::push_bulk(Iterator first, Iterator last)
+{
+    std::size_t n = 0;
+    {
+        std::lock_guard<std::timed_mutex> lock(_mutex);
+        for (; first != last; ++first, n++)
+        {
+            this->insert(*first);
+        }
+    }
+    queue_detail::notify_n(_not_empty, n);
+}
+
+template <typename T, typename Compare>
+template <typename Iterator>
+Iterator PriorityBlockingQueue<T, Compare>::try_push_bulk(Iterator first, Iterator last)
+{
+    push_bulk(first, last);
+    return last;
+}
+
+template <typename T, typename Compare>
+template <typename OutputIterator>
+std::size_t PriorityBlockingQueue<T, Compare>::pop_bulk(OutputIterator out, std::size_t max)
+{
+    std::lock_guard<std::timed_mutex> lock(_mutex);
+    std::size_t n = 0;
+    for (; n < max && !empty(); n++)
+    {
+        *out = this->remove();
+        ++out;
+    }
+    return n;
+}
+
 template <typename T, typename Compare>
 std::size_t PriorityBlockingQueue<T, Compare>::size()
 {
@@ -0,0 +1,189 @@
+#ifndef __WORK_STEALING_DEQUE_HPP__
+#define __WORK_STEALING_DEQUE_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "concurrency/concurrent_queue/concurrent_queue.hpp"
+
+/**
+ * @brief Chase-Lev无锁工作窃取双端队列, 只有所有者线程可以在底部push/take(LIFO), 其他线程从顶部steal(FIFO)
+ *        空间不足时按2倍扩容, 旧数组在队列析构时才释放, 因为并发steal的线程可能还在读取
+ *
+ * @tparam T 元素类型, steal时会与所有者的写入并发读取, 所以必须可以放在std::atomic中, 一般为指针
+ */
+template <typename T>
+class WorkStealingDeque
+{
+private:
+    class Array
+    {
+    private:
+        const std::int64_t _cap;
+        const std::int64_t _mask;
+        std::unique_ptr<std::atomic<T>[]> _slots;
+
+    public:
+        explicit Array(std::int64_t cap) : _cap(cap), _mask(cap - 1), _slots(new std::atomic<T>[cap]) {}
+        std::int64_t cap() const { return _cap; }
+        T get(std::int64_t i) const { return _slots[i & _mask].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, T ele) { _slots[i & _mask].store(ele, std::memory_order_relaxed); }
+    };
+
+    //steal的位置
+    std::atomic<std::int64_t> _top{0};
+    char _pad0[CACHE_LINE_SIZE];
+    //push/take的位置, 只有所有者线程修改
+    std::atomic<std::int64_t> _bottom{0};
+    std::atomic<Array *> _array;
+    //扩容后不再使用的数组
+    std::vector<std::unique_ptr<Array>> _retired;
+
+public:
+    typedef T value_type;
+    /**
+     * @brief 构造函数
+     * @param cap 初始容量, 向上取整为2的幂
+     */
+    explicit WorkStealingDeque(std::size_t cap = 256);
+    ~WorkStealingDeque();
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    /**
+     * @brief 所有者线程在底部放入元素, 不会失败
+     */
+    void push(T ele);
+    /**
+     * @brief 所有者线程从底部取出最后放入的元素
+     *
+     * @param ele 取出元素赋值对象
+     * @return true 取出成功
+     * @return false 队列为空或最后一个元素被steal
+     */
+    bool take(T &ele);
+    /**
+     * @brief 其他线程从顶部取出最早放入的元素
+     *
+     * @param ele 取出元素赋值对象
+     * @return true 取出成功
+     * @return false 队列为空或与其他线程竞争失败
+     */
+    bool steal(T &ele);
+    /**
+     * @brief 返回队列大小, 并发修改时是近似值
+     */
+    std::size_t size();
+    bool empty();
+
+private:
+    Array *grow(Array *array, std::int64_t bottom, std::int64_t top);
+};
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(std::size_t cap)
+{
+    std::int64_t res = 2;
+    while (res < (std::int64_t)cap)
+    {
+        res <<= 1;
+    }
+    _retired.emplace_back(new Array(res));
+    _array.store(_retired.back().get(), std::memory_order_relaxed);
+}
+
+template <typename T>
+WorkStealingDeque<T>::~WorkStealingDeque()
+{
+}
+
+template <typename T>
+typename WorkStealingDeque<T>::Array *WorkStealingDeque<T>::grow(Array *array, std::int64_t bottom, std::int64_t top)
+{
+    Array *res = new Array(array->cap() * 2);
+    for (std::int64_t i = top; i < bottom; i++)
+    {
+        res->put(i, array->get(i));
+    }
+    _retired.emplace_back(res);
+    _array.store(res, std::memory_order_release);
+    return res;
+}
+
+template <typename T>
+void WorkStealingDeque<T>::push(T ele)
+{
+    std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    std::int64_t top = _top.load(std::memory_order_acquire);
+    Array *array = _array.load(std::memory_order_relaxed);
+    if (bottom - top > array->cap() - 1)
+    {
+        array = grow(array, bottom, top);
+    }
+    array->put(bottom, ele);
+    //steal读取到新的bottom时, 一定能看到元素的写入
+    _bottom.store(bottom + 1, std::memory_order_release);
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::take(T &ele)
+{
+    std::int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    Array *array = _array.load(std::memory_order_relaxed);
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = _top.load(std::memory_order_relaxed);
+    if (top > bottom)
+    {
+        //队列为空
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+    ele = array->get(bottom);
+    if (top == bottom)
+    {
+        //最后一个元素, 与steal竞争
+        bool res = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return res;
+    }
+    return true;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::steal(T &ele)
+{
+    std::int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return false;
+    }
+    Array *array = _array.load(std::memory_order_acquire);
+    T res = array->get(top);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return false;
+    }
+    ele = res;
+    return true;
+}
+
+template <typename T>
+std::size_t WorkStealingDeque<T>::size()
+{
+    std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    std::int64_t top = _top.load(std::memory_order_relaxed);
+    return bottom > top ? (std::size_t)(bottom - top) : 0;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::empty()
+{
+    return size() == 0;
+}
+
+#endif /* __WORK_STEALING_DEQUE_HPP__ */
@@ -0,0 +1,111 @@
+#ifndef __EVENT_COUNT_HPP__
+#define __EVENT_COUNT_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief 自旋等待时降低cpu占用和功耗
+ */
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * @brief 基于futex的事件计数, 用于在条件不满足时休眠, 条件本身由调用者检查, 不需要额外的锁
+ *        等待方: key = prepare_wait(); 检查条件, 满足则cancel_wait(), 否则wait(key)
+ *        通知方: 修改条件, 然后notify_one()/notify_all(), 没有等待者时只有一次load
+ *        prepare_wait之后的修改都会让wait立即返回, 所以不会丢失通知, 但被唤醒后条件可能已经被其他线程消耗, 需要重新检查
+ */
+class EventCount
+{
+private:
+    //futex等待的字, 每次通知加1
+    std::atomic<std::uint32_t> _epoch{0};
+    //调用prepare_wait还没有返回的等待者
+    std::atomic<std::uint32_t> _waiters{0};
+
+public:
+    typedef std::uint32_t Key;
+
+    EventCount() = default;
+    EventCount(const EventCount &) = delete;
+    EventCount &operator=(const EventCount &) = delete;
+
+    /**
+     * @brief 登记为等待者, 之后必须调用cancel_wait, wait或wait_for中的一个
+     *
+     * @return Key 传给wait的值
+     */
+    Key prepare_wait();
+    /**
+     * @brief 检查条件后不需要等待时取消登记
+     */
+    void cancel_wait();
+    /**
+     * @brief 休眠到prepare_wait之后有新的通知
+     */
+    void wait(Key key);
+    /**
+     * @brief 休眠到prepare_wait之后有新的通知或超时
+     *
+     * @param key prepare_wait的返回值
+     * @param timeout 超时时间
+     * @return true 收到通知
+     * @return false 超时
+     */
+    bool wait_for(Key key, std::chrono::nanoseconds timeout);
+    /**
+     * @brief 休眠到prepare_wait之后有新的通知或到达时间点
+     *
+     * @tparam Clock 时钟
+     * @tparam Duration 时间单位
+     * @param key prepare_wait的返回值
+     * @param tp 超时时间点
+     * @return true 收到通知
+     * @return false 超时
+     */
+    template <typename Clock, typename Duration>
+    bool wait_until(Key key, const std::chrono::time_point<Clock, Duration> &tp);
+    /**
+     * @brief 唤醒一个等待者
+     */
+    void notify_one();
+    /**
+     * @brief 唤醒所有等待者
+     */
+    void notify_all();
+    /**
+     * @brief 唤醒最多n个等待者, 一次系统调用, 等待者少于n时全部唤醒
+     *
+     * @param n 唤醒数量
+     */
+    void notify(int n);
+};
+
+template <typename Clock, typename Duration>
+bool EventCount::wait_until(Key key, const std::chrono::time_point<Clock, Duration> &tp)
+{
+    auto now = Clock::now();
+    if (tp <= now)
+    {
+        cancel_wait();
+        return _epoch.load(std::memory_order_acquire) != key;
+    }
+    //time_point::max()等很远的时间点换算成纳秒会溢出, 按一直等待处理
+    auto hours = std::chrono::duration_cast<std::chrono::hours>(tp - now);
+    if (hours.count() > 24 * 365)
+    {
+        wait(key);
+        return true;
+    }
+    return wait_for(key, std::chrono::duration_cast<std::chrono::nanoseconds>(tp - now));
+}
+
+#endif /* __EVENT_COUNT_HPP__ */
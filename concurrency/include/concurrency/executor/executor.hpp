@@ -1,12 +1,15 @@
 #ifndef __EXECUTOR_HPP__
 #define __EXECUTOR_HPP__
 
+#include <algorithm>
 #include <atomic>
+#include <climits>
 #include <memory>
 #include <functional>
 #include <string>
 #include <vector>
 
+#include "concurrency/event_count.hpp"
 #include "concurrency/thread/thread_factory.hpp"
 
 template <typename Queue, typename Task>
@@ -29,6 +32,10 @@ protected:
     std::unique_ptr<Queue> _task_queue;
     std::shared_ptr<ThreadFactory> _thread_factory;
     std::vector<ThreadUptr> _threads;
+    //没有任务的任务线程在这里休眠, 放入任务或phase改变时唤醒
+    EventCount _idle;
+    //休眠前最多自旋的次数
+    std::atomic_size_t _spin{0};
 
 protected:
     /**
@@ -39,6 +46,25 @@ protected:
      * @brief 任务线程运行的函数
      */
     virtual void run() = 0;
+    /**
+     * @brief 放入任务后唤醒一个休眠的任务线程
+     */
+    void notify_task();
+    /**
+     * @brief 放入n个任务后唤醒min(n, 休眠线程数)个任务线程
+     */
+    void notify_tasks(std::size_t n);
+    /**
+     * @brief 任务线程没有任务时调用, 先自旋, 然后休眠到有新任务或phase不再是RUNNING
+     *
+     * @param try_get 获取任务, 成功返回true
+     * @param has_task 是否还有任务, try_get因为竞争失败时不会休眠
+     * @param spins 本线程当前的自旋次数, 自旋成功时加倍, 失败时减半, 范围[_spin / 16, _spin]
+     * @return true 获取到任务
+     * @return false phase不再是RUNNING
+     */
+    template <typename TryGet, typename HasTask>
+    bool idle_wait(TryGet try_get, HasTask has_task, std::size_t &spins);
 
 public:
     static const std::size_t RUNNING = 1UL;
@@ -93,6 +119,19 @@ public:
      * @return std::shared_ptr<ThreadFactory> ThreadFactory
      */
     virtual std::shared_ptr<ThreadFactory> thread_factory();
+    /**
+     * @brief 设置任务线程休眠前最多自旋的次数, 0不自旋, 默认为0
+     *        任务密集时自旋可以避免休眠和唤醒的系统调用, 空闲时自旋会浪费cpu
+     *
+     * @param n 自旋次数
+     */
+    virtual void spin(std::size_t n);
+    /**
+     * @brief 获取任务线程休眠前最多自旋的次数
+     *
+     * @return std::size_t 自旋次数
+     */
+    virtual std::size_t spin();
 };
 
 template <typename Queue, typename Task>
@@ -132,16 +171,73 @@ void Executor<Queue, Task>::init_threads()
     }
 }
 
+template <typename Queue, typename Task>
+void Executor<Queue, Task>::notify_task()
+{
+    _idle.notify_one();
+}
+
+template <typename Queue, typename Task>
+void Executor<Queue, Task>::notify_tasks(std::size_t n)
+{
+    if (n > 0)
+    {
+        _idle.notify(static_cast<int>(std::min<std::size_t>(n, INT_MAX)));
+    }
+}
+
+template <typename Queue, typename Task>
+template <typename TryGet, typename HasTask>
+bool Executor<Queue, Task>::idle_wait(TryGet try_get, HasTask has_task, std::size_t &spins)
+{
+    std::size_t max_spin = _spin.load(std::memory_order_relaxed);
+    std::size_t min_spin = (max_spin + 15) / 16;
+    spins = std::min(std::max(spins, min_spin), max_spin);
+    for (std::size_t i = 0; i < spins; i++)
+    {
+        if (try_get())
+        {
+            spins = std::min(spins * 2, max_spin);
+            return true;
+        }
+        if (_phase.load() != RUNNING)
+        {
+            return false;
+        }
+        cpu_relax();
+    }
+    spins = std::max(spins / 2, min_spin);
+
+    while (_phase.load() == RUNNING)
+    {
+        EventCount::Key key = _idle.prepare_wait();
+        if (try_get())
+        {
+            _idle.cancel_wait();
+            return true;
+        }
+        if (_phase.load() != RUNNING || has_task())
+        {
+            _idle.cancel_wait();
+            continue;
+        }
+        _idle.wait(key);
+    }
+    return false;
+}
+
 template <typename Queue, typename Task>
 void Executor<Queue, Task>::shutdown()
 {
     _phase.store(SHUTDOWN);
+    _idle.notify_all();
 }
 
 template <typename Queue, typename Task>
 void Executor<Queue, Task>::stop()
 {
     _phase.store(STOP);
+    _idle.notify_all();
 }
 
 template <typename Queue, typename Task>
@@ -162,4 +258,16 @@ std::shared_ptr<ThreadFactory> Executor<Queue, Task>::thread_factory()
     return _thread_factory;
 }
 
+template <typename Queue, typename Task>
+void Executor<Queue, Task>::spin(std::size_t n)
+{
+    _spin.store(n, std::memory_order_relaxed);
+}
+
+template <typename Queue, typename Task>
+std::size_t Executor<Queue, Task>::spin()
+{
+    return _spin.load(std::memory_order_relaxed);
+}
+
 #endif /* __EXECUTOR_HPP__ */
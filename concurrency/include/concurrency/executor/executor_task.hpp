@@ -3,6 +3,8 @@
 
 #include <functional>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 class ExecutorTask
 {
@@ -24,6 +26,51 @@ public:
     virtual void run();
 };
 
+/**
+ * @brief 直接保存可调用对象的任务, 可调用对象可以只能移动, 与make_shared一起使用只需要申请一次内存
+ *
+ * @tparam F 可调用对象, 无参数
+ */
+template <typename F>
+class CallableExecutorTask : public ExecutorTask
+{
+private:
+    F _func;
+
+public:
+    CallableExecutorTask(F func) : _func(std::move(func)) {}
+    virtual void run() { _func(); }
+};
+
+/**
+ * @brief 线程池队列元素类型相关的操作, 线程池通过它支持不同的任务类型
+ *
+ * @tparam Task 队列元素类型
+ */
+template <typename Task>
+struct TaskTraits;
+
+template <>
+struct TaskTraits<std::shared_ptr<ExecutorTask>>
+{
+    static std::shared_ptr<ExecutorTask> from_executor_task(std::shared_ptr<ExecutorTask> task)
+    {
+        return task;
+    }
+
+    template <typename F>
+    static std::shared_ptr<ExecutorTask> from_function(F &&func)
+    {
+        typedef typename std::decay<F>::type Func;
+        return std::make_shared<CallableExecutorTask<Func>>(std::forward<F>(func));
+    }
+
+    static void run(std::shared_ptr<ExecutorTask> &task)
+    {
+        task->run();
+    }
+};
+
 template<typename Comparator>
 class PairExecutorTaskComparator
 {
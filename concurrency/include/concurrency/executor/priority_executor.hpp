@@ -83,7 +83,12 @@ bool PriorityExecutor::wait_execute(int priority, std::function<void()> &&task,
     }
     else
     {
-        return _task_queue->wait_push(std::make_pair<>(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), priority), wait_duration);
+        if (_task_queue->wait_push(std::make_pair<>(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), priority), wait_duration))
+        {
+            notify_task();
+            return true;
+        }
+        return false;
     }
 }
 
@@ -96,7 +101,12 @@ bool PriorityExecutor::wait_execute(int priority, std::shared_ptr<ExecutorTask>
     }
     else
     {
-        return _task_queue->wait_push(std::pair<std::shared_ptr<ExecutorTask>, int>(task, priority), wait_duration);
+        if (_task_queue->wait_push(std::pair<std::shared_ptr<ExecutorTask>, int>(task, priority), wait_duration))
+        {
+            notify_task();
+            return true;
+        }
+        return false;
     }
 }
 
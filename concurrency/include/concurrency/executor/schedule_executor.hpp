@@ -1,6 +1,7 @@
 #ifndef __SCHEDULE_EXECUTOR_HPP__
 #define __SCHEDULE_EXECUTOR_HPP__
 
+#include <atomic>
 #include <chrono>
 
 #include "concurrency/executor/executor_task.hpp"
@@ -10,6 +11,23 @@
 template <typename Clock = std::chrono::system_clock>
 class ScheduleExecutor : public Executor<DelayQueue<std::shared_ptr<ExecutorTask>, Clock>, std::shared_ptr<ExecutorTask>>
 {
+private:
+    typedef typename Clock::time_point time_point;
+    typedef typename Clock::rep rep;
+
+    //休眠到队首任务到期的线程(leader)等待的时间点, 其他空闲线程一直休眠, 避免到期时所有线程一起被唤醒
+    std::atomic<rep> _leader_until{time_point::max().time_since_epoch().count()};
+
+    /**
+     * @brief 没有到期任务时休眠, 队首任务比当前leader等待的时间更早时成为leader
+     *
+     * @param phase 调用时的phase, phase改变时不休眠
+     * @param task 休眠前任务到期时取出的任务
+     * @return true 取出了任务
+     * @return false 被唤醒或超时, 需要重新检查
+     */
+    bool idle_wait_until(std::size_t phase, std::shared_ptr<ExecutorTask> &task);
+
 protected:
     virtual void run() override;
 
@@ -51,17 +69,51 @@ public:
     bool wait_execute(const std::chrono::duration<Rep, Period> &delay, std::shared_ptr<ExecutorTask> task, const std::chrono::duration<WRep, WPeriod> &wait_duration);
 };
 
+template <typename Clock>
+bool ScheduleExecutor<Clock>::idle_wait_until(std::size_t phase, std::shared_ptr<ExecutorTask> &task)
+{
+    time_point next;
+    EventCount::Key key = this->_idle.prepare_wait();
+    if (this->_task_queue->poll(task, next))
+    {
+        this->_idle.cancel_wait();
+        return true;
+    }
+    //shutdown后队列为空时不休眠, 返回后退出
+    if (this->_phase.load() != phase || (phase == this->SHUTDOWN && next == time_point::max()))
+    {
+        this->_idle.cancel_wait();
+        return false;
+    }
+    rep until = _leader_until.load();
+    rep want = next.time_since_epoch().count();
+    if (next != time_point::max() && want < until && _leader_until.compare_exchange_strong(until, want))
+    {
+        this->_idle.wait_until(key, next);
+        //让出leader, 唤醒一个线程等待下一个任务
+        _leader_until.compare_exchange_strong(want, time_point::max().time_since_epoch().count());
+        this->_idle.notify_one();
+    }
+    else
+    {
+        this->_idle.wait(key);
+    }
+    return false;
+}
+
 template <typename Clock>
 void ScheduleExecutor<Clock>::run() 
 {
     while (1)
     {
         std::shared_ptr<ExecutorTask> task;
-        switch (this->_phase.load())
+        time_point next;
+        std::size_t phase = this->_phase.load();
+        switch (phase)
         {
         case this->RUNNING:
         {
-            if (this->_task_queue->wait_pop(task, std::chrono::milliseconds(10)))
+            if (this->_task_queue->poll(task, next) || idle_wait_until(phase, task))
             {
                 task->run();
             }
@@ -69,13 +121,24 @@ void ScheduleExecutor<Clock>::run()
         }
         case this->SHUTDOWN:
         {
-            if (this->_task_queue->try_pop(task))
+            //shutdown后还要等待剩余的任务到期并执行
+            if (this->_task_queue->poll(task, next))
             {
                 task->run();
                 break;
             }
+            else if (next != time_point::max())
+            {
+                if (idle_wait_until(phase, task))
+                {
+                    task->run();
+                }
+                break;
+            }
             else
             {
+                //唤醒其他休眠的线程退出
+                this->_idle.notify_all();
                 return;
             }
         }
@@ -94,7 +157,11 @@ ScheduleExecutor<Clock>::ScheduleExecutor(std::size_t threads, std::shared_ptr<T
     : Executor<DelayQueue<std::shared_ptr<ExecutorTask>, Clock>, std::shared_ptr<ExecutorTask>>(threads, thread_factory) {}
 
 template <typename Clock>
-ScheduleExecutor<Clock>::~ScheduleExecutor() {}
+ScheduleExecutor<Clock>::~ScheduleExecutor()
+{
+    //run是虚函数, 必须在派生类析构之前等待任务线程结束
+    this->_threads.clear();
+}
 
 template <typename Clock>
 bool ScheduleExecutor<Clock>::execute(std::chrono::time_point<Clock> &time_point, std::shared_ptr<ExecutorTask> task)
@@ -105,7 +172,8 @@ bool ScheduleExecutor<Clock>::execute(std::chrono::time_point<Clock> &time_point
     }
     else
     {
-        this->_task_queue->push(task, time_point);
+        this->_task_queue->push(time_point, task);
+        this->notify_task();
         return true;
     }
 }
@@ -120,6 +188,7 @@ bool ScheduleExecutor<Clock>::execute(std::chrono::time_point<Clock> &time_point
     else
     {
         this->_task_queue->push(time_point, std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)));
+        this->notify_task();
         return true;
     }
 }
@@ -134,6 +203,7 @@ bool ScheduleExecutor<Clock>::try_execute(std::chrono::time_point<Clock> &time_p
     else
     {
         this->_task_queue->try_push(time_point, task);
+        this->notify_task();
         return true;
     }
 }
@@ -148,6 +218,7 @@ bool ScheduleExecutor<Clock>::try_execute(std::chrono::time_point<Clock> &time_p
     else
     {
         this->_task_queue->try_push(time_point, std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)));
+        this->notify_task();
         return true;
     }
 }
@@ -163,6 +234,7 @@ bool ScheduleExecutor<Clock>::wait_execute(std::chrono::time_point<Clock> &time_
     else
     {
         this->_task_queue->wait_push(time_point, std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), wait_duration);
+        this->notify_task();
         return true;
     }
 }
@@ -178,6 +250,7 @@ bool ScheduleExecutor<Clock>::wait_execute(std::chrono::time_point<Clock> &time_
     else
     {
         this->_task_queue->wait_push(time_point, task, wait_duration);
+        this->notify_task();
         return true;
     }
 }
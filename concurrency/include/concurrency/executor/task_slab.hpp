@@ -0,0 +1,33 @@
+#ifndef __TASK_SLAB_HPP__
+#define __TASK_SLAB_HPP__
+
+#include <cstddef>
+
+/**
+ * @brief UniqueTask中放不下的闭包使用的内存池, 按64, 128, 256, 512字节分级, 更大的闭包直接使用operator new
+ *        每个线程缓存一部分空闲块, 缓存为空或过多时与全局空闲链表成批交换, 生产者申请, 消费者释放时内存也能循环使用
+ *        全局空闲链表为空时一次申请一个slab切分成多个块, slab在程序退出时才释放
+ */
+class TaskSlab
+{
+public:
+    //使用内存池的最大块大小
+    static const std::size_t MAX_SIZE = 512;
+
+    /**
+     * @brief 申请内存, 按alignof(std::max_align_t)对齐
+     *
+     * @param size 字节数
+     * @return void* 内存地址
+     */
+    static void *allocate(std::size_t size);
+    /**
+     * @brief 释放内存, 可以在与申请不同的线程中调用
+     *
+     * @param p allocate返回的地址
+     * @param size 申请时的字节数
+     */
+    static void deallocate(void *p, std::size_t size);
+};
+
+#endif /* __TASK_SLAB_HPP__ */
@@ -1,12 +1,42 @@
 #ifndef __THREAD_POOL_EXECUTOR_HPP__
 #define __THREAD_POOL_EXECUTOR_HPP__
 
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
 #include "concurrency/executor/executor_task.hpp"
 #include "concurrency/executor/executor.hpp"
+#include "concurrency/executor/unique_task.hpp"
+#include "concurrency/future.hpp"
 
+/**
+ * @brief 线程池, 队列元素类型为std::shared_ptr<ExecutorTask>或UniqueTask
+ *        使用UniqueTask队列时, 不超过UniqueTask::INLINE_SIZE字节的任务入队出队不需要申请内存
+ *
+ * @tparam Queue 任务队列
+ */
 template <typename Queue>
-class ThreadPoolExecutor : public Executor<Queue, std::shared_ptr<ExecutorTask>>
+class ThreadPoolExecutor : public Executor<Queue, typename Queue::value_type>
 {
+private:
+    typedef typename Queue::value_type Task;
+    typedef TaskTraits<Task> Traits;
+    //可调用对象, ExecutorTask使用单独的重载
+    template <typename F>
+    using EnableIfFunction = typename std::enable_if<!std::is_convertible<F, std::shared_ptr<ExecutorTask>>::value>::type;
+
+    /**
+     * @brief then注册的后续任务放入本线程池, 队列已满或已经shutdown时在当前线程执行, 避免阻塞任务线程
+     */
+    ContinuationExecutor continuation_executor();
+    /**
+     * @brief 转换为队列元素
+     */
+    static Task make_task(std::shared_ptr<ExecutorTask> task);
+    template <typename F, typename = EnableIfFunction<F>>
+    static Task make_task(F &&task);
+
 protected:
     virtual void run() override;
 
@@ -30,7 +60,8 @@ public:
      * @return true 任务放入队列成功
      * @return false 任务放入队列失败
      */
-    bool execute(std::function<void()> &&task);
+    template <typename F, typename = EnableIfFunction<F>>
+    bool execute(F &&task);
     /**
      * @brief 尝试将任务放入队列
      * 
@@ -46,7 +77,8 @@ public:
      * @return true 任务放入队列成功
      * @return false 任务放入队列失败
      */
-    bool try_execute(std::function<void()> &&task);
+    template <typename F, typename = EnableIfFunction<F>>
+    bool try_execute(F &&task);
     /**
      * @brief 等待将任务放入队列, shutdown、stop或超时后, 将会失败
      * 
@@ -57,8 +89,8 @@ public:
      * @return true 任务放入队列成功
      * @return false 任务放入队列失败
      */
-    template <class Rep, class Period>
-    bool wait_execute(std::function<void()> &&task, const std::chrono::duration<Rep, Period> &wait_duration);
+    template <typename F, class Rep, class Period, typename = EnableIfFunction<F>>
+    bool wait_execute(F &&task, const std::chrono::duration<Rep, Period> &wait_duration);
     /**
      * @brief 等待将任务放入队列, shutdown、stop或超时后, 将会失败
      * 
@@ -71,21 +103,52 @@ public:
      */
     template <class Rep, class Period>
     bool wait_execute(std::shared_ptr<ExecutorTask> task, const std::chrono::duration<Rep, Period> &wait_duration);
+    /**
+     * @brief 批量将任务放入队列, 每次加锁放入尽量多的任务, 并唤醒min(放入数量, 休眠线程数)个任务线程
+     *        队列已满时阻塞到任务全部放入, 队列需要提供try_push_bulk
+     *        shutdown或stop后, 将会失败
+     *
+     * @tparam Iterator 输入迭代器, 元素为std::shared_ptr<ExecutorTask>或可调用对象, 由*first构造任务
+     *                  可调用对象只能移动时传入std::make_move_iterator
+     * @param first 第一个任务
+     * @param last 最后一个任务之后
+     * @return true 任务全部放入队列
+     * @return false 任务放入队列失败
+     */
+    template <typename Iterator>
+    bool execute_bulk(Iterator first, Iterator last);
+    /**
+     * @brief 将任务放入队列, 返回任务的结果, 阻塞情况与execute相同
+     *        shutdown或stop后, 返回的Future中是std::runtime_error, 任务抛出的异常也设置到Future中
+     *        Future::then注册的后续任务也在本线程池中执行, 后续任务完成前线程池不能析构
+     *
+     * @tparam F 可调用对象
+     * @tparam Args 参数类型
+     * @param func 要执行的任务
+     * @param args 参数, 会被复制
+     * @return Future<R> 任务的结果
+     */
+    template <typename F, typename... Args>
+    Future<typename std::result_of<F(Args...)>::type> submit(F &&func, Args &&...args);
 };
 
 template<typename Queue>
 void ThreadPoolExecutor<Queue>::run() 
 {
+    std::size_t spins = this->spin();
     while (1)
     {
-        std::shared_ptr<ExecutorTask> task;
+        Task task;
         switch (this->_phase.load())
         {
         case this->RUNNING:
         {
-            if (this->_task_queue->wait_pop(task, std::chrono::milliseconds(10)))
+            //没有任务时休眠, 直到放入任务或phase改变
+            if (this->_task_queue->try_pop(task) ||
+                this->idle_wait([&]() { return this->_task_queue->try_pop(task); },
+                                [&]() { return !this->_task_queue->empty(); }, spins))
             {
-                task->run();
+                Traits::run(task);
             }
             break;
         }
@@ -93,7 +156,7 @@ void ThreadPoolExecutor<Queue>::run()
         {
             if (this->_task_queue->try_pop(task))
             {
-                task->run();
+                Traits::run(task);
                 break;
             }
             else
@@ -113,14 +176,18 @@ void ThreadPoolExecutor<Queue>::run()
 
 template <typename Queue>
 ThreadPoolExecutor<Queue>::ThreadPoolExecutor(std::size_t threads, std::unique_ptr<Queue> task_queue, std::shared_ptr<ThreadFactory> thread_factory)
-    : Executor<Queue, std::shared_ptr<ExecutorTask>>(threads, std::move(task_queue), thread_factory) {}
+    : Executor<Queue, Task>(threads, std::move(task_queue), thread_factory) {}
 
 template <typename Queue>
 ThreadPoolExecutor<Queue>::ThreadPoolExecutor(std::size_t threads, std::shared_ptr<ThreadFactory> thread_factory)
-    : Executor<Queue, std::shared_ptr<ExecutorTask>>(threads, thread_factory) {}
+    : Executor<Queue, Task>(threads, thread_factory) {}
 
 template <typename Queue>
-ThreadPoolExecutor<Queue>::~ThreadPoolExecutor() {}
+ThreadPoolExecutor<Queue>::~ThreadPoolExecutor()
+{
+    //run是虚函数, 必须在派生类析构之前等待任务线程结束
+    this->_threads.clear();
+}
 
 template <typename Queue>
 bool ThreadPoolExecutor<Queue>::execute(std::shared_ptr<ExecutorTask> task)
@@ -131,13 +198,15 @@ bool ThreadPoolExecutor<Queue>::execute(std::shared_ptr<ExecutorTask> task)
     }
     else
     {
-        this->_task_queue->push(task);
+        this->_task_queue->push(Traits::from_executor_task(std::move(task)));
+        this->notify_task();
         return true;
     }
 }
 
 template <typename Queue>
-bool ThreadPoolExecutor<Queue>::execute(std::function<void()> &&task)
+template <typename F, typename>
+bool ThreadPoolExecutor<Queue>::execute(F &&task)
 {
     if (this->_phase != this->RUNNING)
     {
@@ -145,7 +214,8 @@ bool ThreadPoolExecutor<Queue>::execute(std::function<void()> &&task)
     }
     else
     {
-        this->_task_queue->push(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)));
+        this->_task_queue->push(Traits::from_function(std::forward<F>(task)));
+        this->notify_task();
         return true;
     }
 }
@@ -159,12 +229,18 @@ bool ThreadPoolExecutor<Queue>::try_execute(std::shared_ptr<ExecutorTask> task)
     }
     else
     {
-        return this->_task_queue->try_push(task);
+        if (this->_task_queue->try_push(Traits::from_executor_task(std::move(task))))
+        {
+            this->notify_task();
+            return true;
+        }
+        return false;
     }
 }
 
 template <typename Queue>
-bool ThreadPoolExecutor<Queue>::try_execute(std::function<void()> &&task)
+template <typename F, typename>
+bool ThreadPoolExecutor<Queue>::try_execute(F &&task)
 {
     if (this->_phase != this->RUNNING)
     {
@@ -172,13 +248,18 @@ bool ThreadPoolExecutor<Queue>::try_execute(std::function<void()> &&task)
     }
     else
     {
-        return this->_task_queue->try_push(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)));
+        if (this->_task_queue->try_push(Traits::from_function(std::forward<F>(task))))
+        {
+            this->notify_task();
+            return true;
+        }
+        return false;
     }
 }
 
 template <typename Queue>
-template <class Rep, class Period>
-bool ThreadPoolExecutor<Queue>::wait_execute(std::function<void()> &&task, const std::chrono::duration<Rep, Period> &wait_duration)
+template <typename F, class Rep, class Period, typename>
+bool ThreadPoolExecutor<Queue>::wait_execute(F &&task, const std::chrono::duration<Rep, Period> &wait_duration)
 {
     if (this->_phase != this->RUNNING)
     {
@@ -186,7 +267,12 @@ bool ThreadPoolExecutor<Queue>::wait_execute(std::function<void()> &&task, const
     }
     else
     {
-        return this->_task_queue->wait_push(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), wait_duration);
+        if (this->_task_queue->wait_push(Traits::from_function(std::forward<F>(task)), wait_duration))
+        {
+            this->notify_task();
+            return true;
+        }
+        return false;
     }
 }
 
@@ -200,8 +286,91 @@ bool ThreadPoolExecutor<Queue>::wait_execute(std::shared_ptr<ExecutorTask> task,
     }
     else
     {
-        return this->_task_queue->wait_push(task, wait_duration);
+        if (this->_task_queue->wait_push(Traits::from_executor_task(std::move(task)), wait_duration))
+        {
+            this->notify_task();
+            return true;
+        }
+        return false;
+    }
+}
+
+template <typename Queue>
+template <typename Iterator>
+bool ThreadPoolExecutor<Queue>::execute_bulk(Iterator first, Iterator last)
+{
+    if (this->_phase != this->RUNNING)
+    {
+        return false;
+    }
+    //在锁外构造任务
+    std::vector<Task> tasks;
+    for (; first != last; ++first)
+    {
+        tasks.push_back(make_task(*first));
+    }
+    auto it = std::make_move_iterator(tasks.begin());
+    auto end = std::make_move_iterator(tasks.end());
+    while (it != end)
+    {
+        auto next = this->_task_queue->try_push_bulk(it, end);
+        this->notify_tasks(next - it);
+        it = next;
+        if (it != end)
+        {
+            //队列已满, 任务线程都在执行任务, 阻塞地放入一个后再批量放入
+            this->_task_queue->push(*it);
+            this->notify_task();
+            ++it;
+        }
+    }
+    return true;
+}
+
+template <typename Queue>
+typename ThreadPoolExecutor<Queue>::Task ThreadPoolExecutor<Queue>::make_task(std::shared_ptr<ExecutorTask> task)
+{
+    return Traits::from_executor_task(std::move(task));
+}
+
+template <typename Queue>
+template <typename F, typename>
+typename ThreadPoolExecutor<Queue>::Task ThreadPoolExecutor<Queue>::make_task(F &&task)
+{
+    return Traits::from_function(std::forward<F>(task));
+}
+
+template <typename Queue>
+ContinuationExecutor ThreadPoolExecutor<Queue>::continuation_executor()
+{
+    return [this](UniqueTask task) {
+        //try_push失败时不会移走任务, 在当前线程执行
+        Task element = make_task(std::move(task));
+        if (this->_phase == this->RUNNING && this->_task_queue->try_push(std::move(element)))
+        {
+            this->notify_task();
+        }
+        else
+        {
+            Traits::run(element);
+        }
+    };
+}
+
+template <typename Queue>
+template <typename F, typename... Args>
+Future<typename std::result_of<F(Args...)>::type> ThreadPoolExecutor<Queue>::submit(F &&func, Args &&...args)
+{
+    typedef typename std::result_of<F(Args...)>::type R;
+    auto bound = std::bind(std::forward<F>(func), std::forward<Args>(args)...);
+    future_detail::PromiseTask<R, decltype(bound)> task{Promise<R>(continuation_executor()), std::move(bound)};
+    Future<R> res = task.promise.get_future();
+    //放入队列失败时任务没有被移走
+    if (!execute(std::move(task)))
+    {
+        task.promise.set_exception(std::make_exception_ptr(std::runtime_error("ThreadPoolExecutor is not running")));
     }
+    return res;
 }
 
 #endif /* __THREAD_POOL_EXECUTOR_HPP__ */
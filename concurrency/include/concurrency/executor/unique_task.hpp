@@ -0,0 +1,176 @@
+#ifndef __UNIQUE_TASK_HPP__
+#define __UNIQUE_TASK_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency/executor/executor_task.hpp"
+#include "concurrency/executor/task_slab.hpp"
+
+/**
+ * @brief 只能移动的任务, 不超过INLINE_SIZE字节的闭包直接保存在对象内, 更大的闭包从TaskSlab申请内存
+ *        与std::shared_ptr<FunctionExecutorTask>相比, 小任务入队出队不需要申请内存, 也没有引用计数
+ *        对象大小为一个缓存行, 用作线程池队列的元素类型
+ */
+class UniqueTask
+{
+public:
+    static const std::size_t INLINE_SIZE = 48;
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void *storage);
+        //将src中的任务移动到未初始化的dst, 并析构src
+        void (*move)(void *dst, void *src);
+        void (*destroy)(void *storage);
+        bool on_heap;
+    };
+
+    template <typename F>
+    struct InlineOps
+    {
+        static void invoke(void *storage) { (*static_cast<F *>(storage))(); }
+        static void move(void *dst, void *src)
+        {
+            new (dst) F(std::move(*static_cast<F *>(src)));
+            static_cast<F *>(src)->~F();
+        }
+        static void destroy(void *storage) { static_cast<F *>(storage)->~F(); }
+        static const Ops ops;
+    };
+
+    //对象内只保存指针
+    template <typename F>
+    struct HeapOps
+    {
+        static F *&ptr(void *storage) { return *static_cast<F **>(storage); }
+        static void invoke(void *storage) { (*ptr(storage))(); }
+        static void move(void *dst, void *src) { new (dst) F *(ptr(src)); }
+        static void destroy(void *storage)
+        {
+            F *func = ptr(storage);
+            func->~F();
+            TaskSlab::deallocate(func, sizeof(F));
+        }
+        static const Ops ops;
+    };
+
+    template <typename F>
+    struct IsInline
+    {
+        static const bool value = sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) &&
+                                  std::is_nothrow_move_constructible<F>::value;
+    };
+
+    typename std::aligned_storage<INLINE_SIZE, alignof(std::max_align_t)>::type _storage;
+    const Ops *_ops = nullptr;
+
+    template <typename F>
+    void init(F &&func, std::true_type);
+    template <typename F>
+    void init(F &&func, std::false_type);
+
+public:
+    UniqueTask() noexcept;
+    UniqueTask(std::nullptr_t) noexcept;
+    /**
+     * @brief 构造函数
+     *
+     * @tparam F 可调用对象, 无参数, 返回值被忽略
+     * @param func 任务
+     */
+    template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, UniqueTask>::value>::type>
+    UniqueTask(F &&func);
+    UniqueTask(UniqueTask &&other) noexcept;
+    UniqueTask &operator=(UniqueTask &&other) noexcept;
+    ~UniqueTask();
+    UniqueTask(const UniqueTask &) = delete;
+    UniqueTask &operator=(const UniqueTask &) = delete;
+
+    /**
+     * @brief 执行任务, 任务为空时行为未定义
+     */
+    void operator()();
+    explicit operator bool() const noexcept;
+    /**
+     * @brief 任务是否保存在对象内
+     */
+    bool is_inline() const noexcept;
+
+private:
+    void reset() noexcept;
+};
+
+template <typename F>
+const UniqueTask::Ops UniqueTask::InlineOps<F>::ops = {&InlineOps<F>::invoke, &InlineOps<F>::move, &InlineOps<F>::destroy, false};
+
+template <typename F>
+const UniqueTask::Ops UniqueTask::HeapOps<F>::ops = {&HeapOps<F>::invoke, &HeapOps<F>::move, &HeapOps<F>::destroy, true};
+
+template <typename F, typename>
+UniqueTask::UniqueTask(F &&func)
+{
+    typedef typename std::decay<F>::type Func;
+    init(std::forward<F>(func), std::integral_constant<bool, IsInline<Func>::value>());
+}
+
+template <typename F>
+void UniqueTask::init(F &&func, std::true_type)
+{
+    typedef typename std::decay<F>::type Func;
+    new (&_storage) Func(std::forward<F>(func));
+    _ops = &InlineOps<Func>::ops;
+}
+
+template <typename F>
+void UniqueTask::init(F &&func, std::false_type)
+{
+    typedef typename std::decay<F>::type Func;
+    static_assert(alignof(Func) <= alignof(std::max_align_t), "over-aligned task is not supported");
+    void *p = TaskSlab::allocate(sizeof(Func));
+    try
+    {
+        new (&_storage) Func *(new (p) Func(std::forward<F>(func)));
+    }
+    catch (...)
+    {
+        TaskSlab::deallocate(p, sizeof(Func));
+        throw;
+    }
+    _ops = &HeapOps<Func>::ops;
+}
+
+/**
+ * @brief UniqueTask队列直接保存闭包, ExecutorTask包装为闭包
+ */
+template <>
+struct TaskTraits<UniqueTask>
+{
+    struct ExecutorTaskRunner
+    {
+        std::shared_ptr<ExecutorTask> task;
+        void operator()() { task->run(); }
+    };
+
+    static UniqueTask from_executor_task(std::shared_ptr<ExecutorTask> task)
+    {
+        return UniqueTask(ExecutorTaskRunner{std::move(task)});
+    }
+
+    template <typename F>
+    static UniqueTask from_function(F &&func)
+    {
+        return UniqueTask(std::forward<F>(func));
+    }
+
+    static void run(UniqueTask &task)
+    {
+        task();
+    }
+};
+
+#endif /* __UNIQUE_TASK_HPP__ */
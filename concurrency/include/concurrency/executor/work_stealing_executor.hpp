@@ -0,0 +1,453 @@
+#ifndef __WORK_STEALING_EXECUTOR_HPP__
+#define __WORK_STEALING_EXECUTOR_HPP__
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "concurrency/executor/executor_task.hpp"
+#include "concurrency/executor/executor.hpp"
+#include "concurrency/concurrent_queue/work_stealing_deque.hpp"
+
+/**
+ * @brief 工作窃取线程池, 每个任务线程有自己的Chase-Lev双端队列
+ *        任务线程中提交的任务放入自己的队列(LIFO, 后续任务使用的数据还在缓存中), 其他线程提交的任务放入共享的Queue
+ *        任务线程依次从自己的队列, 共享队列, 其他线程的队列(FIFO)中获取任务, 适合fork/join风格的任务拆分
+ *
+ * @tparam Queue 共享的任务队列
+ */
+template <typename Queue>
+class WorkStealingExecutor : public Executor<Queue, std::shared_ptr<ExecutorTask>>
+{
+private:
+    //保存任务的槽, 由所属worker分配并循环使用, 取出任务后放回所属worker
+    struct Slot
+    {
+        std::shared_ptr<ExecutorTask> task;
+        Slot *next = nullptr;
+    };
+    //双端队列中的元素需要可以原子读写, 所以保存槽的指针
+    //steal在CAS成功之前就会读取元素, 任务不能直接保存在双端队列的数组中
+    typedef Slot *TaskPtr;
+    typedef WorkStealingDeque<TaskPtr> Deque;
+    //槽不足时一次申请的数量
+    static const std::size_t SLOT_CHUNK = 64;
+
+    struct Worker
+    {
+        Deque deque;
+        //选择窃取对象的随机数状态
+        std::uint64_t seed;
+        //空闲的槽, 只有所属线程访问
+        Slot *free_slots = nullptr;
+        //其他线程窃取任务后放回的槽, 所属线程一次全部取出
+        std::atomic<Slot *> stolen_slots{nullptr};
+        //所有槽, 析构时释放
+        std::vector<std::unique_ptr<Slot[]>> chunks;
+
+        explicit Worker(std::uint64_t seed) : seed(seed) {}
+        /**
+         * @brief 所属线程取出一个空闲槽, 本地没有时取回被窃取的槽, 都没有时申请一批
+         */
+        Slot *acquire_slot();
+        /**
+         * @brief 取出槽中的任务并放回槽, 可以在任何线程调用
+         */
+        void release_slot(Slot *slot, std::shared_ptr<ExecutorTask> &task, bool local);
+    };
+
+    //当前线程所在的executor和worker, 不是任务线程时都为nullptr
+    struct Context
+    {
+        const WorkStealingExecutor *executor = nullptr;
+        Worker *worker = nullptr;
+    };
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<std::size_t> _next_worker{0};
+
+    static Context &context();
+    /**
+     * @brief 依次从自己的队列, 共享队列, 其他线程的队列中获取任务
+     *
+     * @param worker 当前线程的worker
+     * @param task 获取到的任务
+     * @return true 获取成功
+     * @return false 所有队列都为空
+     */
+    bool next_task(Worker *worker, std::shared_ptr<ExecutorTask> &task);
+    bool steal(Worker *worker, std::shared_ptr<ExecutorTask> &task);
+    /**
+     * @brief 共享队列或任何线程的队列中还有任务
+     */
+    bool has_task();
+    /**
+     * @brief 当前线程是本executor的任务线程时, 返回它的worker
+     */
+    Worker *local_worker();
+    /**
+     * @brief 任务线程中提交的任务在shutdown后也接受, 它们是正在执行的旧任务拆分出来的, stop后拒绝
+     */
+    bool accept_local(Worker *worker);
+    void push_local(Worker *worker, std::shared_ptr<ExecutorTask> &&task);
+
+protected:
+    virtual void run() override;
+
+public:
+    WorkStealingExecutor(std::size_t threads, std::unique_ptr<Queue> task_queue, std::shared_ptr<ThreadFactory> thread_factory);
+    WorkStealingExecutor(std::size_t threads, std::shared_ptr<ThreadFactory> thread_factory);
+    /**
+     * @brief 还在运行时先shutdown, 等待任务线程结束, 然后释放没有执行的任务
+     */
+    ~WorkStealingExecutor();
+
+    /**
+     * @brief 将任务放入队列, shutdown或stop后, 将会失败
+     *        在任务线程中调用时放入本线程的队列, 不会阻塞, shutdown后也可以提交, 否则一直阻塞到task放进共享队列
+     *
+     * @param task 要执行的任务
+     * @return true 任务放入队列成功
+     * @return false 任务放入队列失败
+     */
+    bool execute(std::shared_ptr<ExecutorTask> task);
+    /**
+     * @brief 将任务放入队列, shutdown或stop后, 将会失败
+     *        在任务线程中调用时放入本线程的队列, 不会阻塞, shutdown后也可以提交, 否则一直阻塞到task放进共享队列
+     *
+     * @param task 要执行的任务
+     * @return true 任务放入队列成功
+     * @return false 任务放入队列失败
+     */
+    bool execute(std::function<void()> &&task);
+    /**
+     * @brief 尝试将任务放入队列, 在任务线程中调用时总是成功
+     *
+     * @param task 要执行的任务
+     * @return true 任务放入队列成功
+     * @return false 任务放入队列失败
+     */
+    bool try_execute(std::shared_ptr<ExecutorTask> task);
+    /**
+     * @brief 尝试将任务放入队列, 在任务线程中调用时总是成功
+     *
+     * @param task 要执行的任务
+     * @return true 任务放入队列成功
+     * @return false 任务放入队列失败
+     */
+    bool try_execute(std::function<void()> &&task);
+    /**
+     * @brief 等待将任务放入队列, shutdown、stop或超时后, 将会失败, 在任务线程中调用时不会等待
+     *
+     * @tparam Rep 时间单位的类型
+     * @tparam Period 时间单位
+     * @param task 要执行的任务
+     * @param wait_duration 等待时间
+     * @return true 任务放入队列成功
+     * @return false 任务放入队列失败
+     */
+    template <class Rep, class Period>
+    bool wait_execute(std::function<void()> &&task, const std::chrono::duration<Rep, Period> &wait_duration);
+    /**
+     * @brief 等待将任务放入队列, shutdown、stop或超时后, 将会失败, 在任务线程中调用时不会等待
+     *
+     * @tparam Rep 时间单位的类型
+     * @tparam Period 时间单位
+     * @param task 要执行的任务
+     * @param wait_duration 等待时间
+     * @return true 任务放入队列成功
+     * @return false 任务放入队列失败
+     */
+    template <class Rep, class Period>
+    bool wait_execute(std::shared_ptr<ExecutorTask> task, const std::chrono::duration<Rep, Period> &wait_duration);
+};
+
+template <typename Queue>
+typename WorkStealingExecutor<Queue>::Slot *WorkStealingExecutor<Queue>::Worker::acquire_slot()
+{
+    if (free_slots == nullptr)
+    {
+        free_slots = stolen_slots.exchange(nullptr, std::memory_order_acquire);
+    }
+    if (free_slots == nullptr)
+    {
+        Slot *chunk = new Slot[SLOT_CHUNK];
+        chunks.emplace_back(chunk);
+        for (std::size_t i = 0; i + 1 < SLOT_CHUNK; i++)
+        {
+            chunk[i].next = &chunk[i + 1];
+        }
+        free_slots = chunk;
+    }
+    Slot *slot = free_slots;
+    free_slots = slot->next;
+    return slot;
+}
+
+template <typename Queue>
+void WorkStealingExecutor<Queue>::Worker::release_slot(Slot *slot, std::shared_ptr<ExecutorTask> &task, bool local)
+{
+    task = std::move(slot->task);
+    if (local)
+    {
+        slot->next = free_slots;
+        free_slots = slot;
+    }
+    else
+    {
+        //多个窃取线程放回, 所属线程只用exchange一次取出全部, 没有ABA问题
+        slot->next = stolen_slots.load(std::memory_order_relaxed);
+        while (!stolen_slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+template <typename Queue>
+typename WorkStealingExecutor<Queue>::Context &WorkStealingExecutor<Queue>::context()
+{
+    static thread_local Context res;
+    return res;
+}
+
+template <typename Queue>
+typename WorkStealingExecutor<Queue>::Worker *WorkStealingExecutor<Queue>::local_worker()
+{
+    Context &ctx = context();
+    return ctx.executor == this ? ctx.worker : nullptr;
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::accept_local(Worker *worker)
+{
+    return worker != nullptr && (this->_phase == this->RUNNING || this->_phase == this->SHUTDOWN);
+}
+
+template <typename Queue>
+void WorkStealingExecutor<Queue>::push_local(Worker *worker, std::shared_ptr<ExecutorTask> &&task)
+{
+    Slot *slot = worker->acquire_slot();
+    slot->task = std::move(task);
+    worker->deque.push(slot);
+    //唤醒空闲的线程来窃取
+    this->notify_task();
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::steal(Worker *worker, std::shared_ptr<ExecutorTask> &task)
+{
+    std::size_t n = _workers.size();
+    //xorshift, 随机选择开始窃取的位置, 避免空闲线程都去窃取同一个线程
+    worker->seed ^= worker->seed << 13;
+    worker->seed ^= worker->seed >> 7;
+    worker->seed ^= worker->seed << 17;
+    std::size_t start = (std::size_t)(worker->seed % n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        Worker *victim = _workers[(start + i) % n].get();
+        TaskPtr ptr;
+        if (victim != worker && victim->deque.steal(ptr))
+        {
+            victim->release_slot(ptr, task, false);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::next_task(Worker *worker, std::shared_ptr<ExecutorTask> &task)
+{
+    TaskPtr ptr;
+    if (worker->deque.take(ptr))
+    {
+        worker->release_slot(ptr, task, true);
+        return true;
+    }
+    return this->_task_queue->try_pop(task) || steal(worker, task);
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::has_task()
+{
+    if (!this->_task_queue->empty())
+    {
+        return true;
+    }
+    for (auto &worker : _workers)
+    {
+        if (!worker->deque.empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Queue>
+void WorkStealingExecutor<Queue>::run()
+{
+    Worker *worker = _workers[_next_worker.fetch_add(1) % _workers.size()].get();
+    Context &ctx = context();
+    ctx.executor = this;
+    ctx.worker = worker;
+    std::size_t spins = this->spin();
+
+    while (1)
+    {
+        std::shared_ptr<ExecutorTask> task;
+        switch (this->_phase.load())
+        {
+        case this->RUNNING:
+        {
+            //所有队列都为空时休眠, 直到放入任务或phase改变
+            if (next_task(worker, task) ||
+                this->idle_wait([&]() { return next_task(worker, task); },
+                                [&]() { return has_task(); }, spins))
+            {
+                task->run();
+            }
+            break;
+        }
+        case this->SHUTDOWN:
+        {
+            //自己的队列为空后还要帮其他线程执行完剩余的任务
+            if (next_task(worker, task))
+            {
+                task->run();
+                break;
+            }
+            else
+            {
+                ctx.executor = nullptr;
+                ctx.worker = nullptr;
+                return;
+            }
+        }
+        case this->STOP:
+        {
+            ctx.executor = nullptr;
+            ctx.worker = nullptr;
+            return;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+template <typename Queue>
+WorkStealingExecutor<Queue>::WorkStealingExecutor(std::size_t threads, std::unique_ptr<Queue> task_queue, std::shared_ptr<ThreadFactory> thread_factory)
+    : Executor<Queue, std::shared_ptr<ExecutorTask>>(threads, std::move(task_queue), thread_factory)
+{
+    for (std::size_t i = 0; i < threads; i++)
+    {
+        _workers.emplace_back(new Worker(0x9E3779B97F4A7C15ULL * (i + 1)));
+    }
+}
+
+template <typename Queue>
+WorkStealingExecutor<Queue>::WorkStealingExecutor(std::size_t threads, std::shared_ptr<ThreadFactory> thread_factory)
+    : Executor<Queue, std::shared_ptr<ExecutorTask>>(threads, thread_factory)
+{
+    for (std::size_t i = 0; i < threads; i++)
+    {
+        _workers.emplace_back(new Worker(0x9E3779B97F4A7C15ULL * (i + 1)));
+    }
+}
+
+template <typename Queue>
+WorkStealingExecutor<Queue>::~WorkStealingExecutor()
+{
+    if (this->_phase == this->RUNNING)
+    {
+        this->shutdown();
+    }
+    //任务线程使用_workers, 必须在_workers析构之前结束
+    this->_threads.clear();
+    //没有执行的任务在槽中, 随worker一起释放
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::execute(std::shared_ptr<ExecutorTask> task)
+{
+    Worker *worker = local_worker();
+    if (accept_local(worker))
+    {
+        push_local(worker, std::move(task));
+    }
+    else if (this->_phase == this->RUNNING)
+    {
+        this->_task_queue->push(task);
+        this->notify_task();
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::execute(std::function<void()> &&task)
+{
+    return execute(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)));
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::try_execute(std::shared_ptr<ExecutorTask> task)
+{
+    Worker *worker = local_worker();
+    if (accept_local(worker))
+    {
+        push_local(worker, std::move(task));
+        return true;
+    }
+    if (this->_phase != this->RUNNING)
+    {
+        return false;
+    }
+    if (this->_task_queue->try_push(task))
+    {
+        this->notify_task();
+        return true;
+    }
+    return false;
+}
+
+template <typename Queue>
+bool WorkStealingExecutor<Queue>::try_execute(std::function<void()> &&task)
+{
+    return try_execute(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)));
+}
+
+template <typename Queue>
+template <class Rep, class Period>
+bool WorkStealingExecutor<Queue>::wait_execute(std::function<void()> &&task, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    return wait_execute(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), wait_duration);
+}
+
+template <typename Queue>
+template <class Rep, class Period>
+bool WorkStealingExecutor<Queue>::wait_execute(std::shared_ptr<ExecutorTask> task, const std::chrono::duration<Rep, Period> &wait_duration)
+{
+    Worker *worker = local_worker();
+    if (accept_local(worker))
+    {
+        push_local(worker, std::move(task));
+        return true;
+    }
+    if (this->_phase != this->RUNNING)
+    {
+        return false;
+    }
+    if (this->_task_queue->wait_push(task, wait_duration))
+    {
+        this->notify_task();
+        return true;
+    }
+    return false;
+}
+
+#endif /* __WORK_STEALING_EXECUTOR_HPP__ */
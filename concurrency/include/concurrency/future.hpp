@@ -0,0 +1,672 @@
+#ifndef __FUTURE_HPP__
+#define __FUTURE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concurrency/executor/unique_task.hpp"
+
+/**
+ * @brief 执行后续任务的函数, 一般把任务放入线程池, 为空时在设置结果的线程中直接执行
+ *        任务为UniqueTask, 不超过UniqueTask::INLINE_SIZE字节的后续任务不需要申请内存
+ */
+typedef std::function<void(UniqueTask)> ContinuationExecutor;
+
+template <typename T>
+class Future;
+template <typename T>
+class Promise;
+
+namespace future_detail
+{
+    //void结果占位
+    struct Unit
+    {
+    };
+
+    template <typename T>
+    struct Storage
+    {
+        typedef T type;
+    };
+
+    template <>
+    struct Storage<void>
+    {
+        typedef Unit type;
+    };
+
+    /**
+     * @brief Promise和Future共享的结果, 只能设置一次, 可以注册一个结果就绪时的回调
+     */
+    template <typename T>
+    class SharedState
+    {
+    public:
+        typedef typename Storage<T>::type value_type;
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        bool _ready = false;
+        bool _has_value = false;
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type _value;
+        std::exception_ptr _exception;
+        UniqueTask _callback;
+        ContinuationExecutor _executor;
+
+        void complete(std::unique_lock<std::mutex> &lock)
+        {
+            _ready = true;
+            UniqueTask callback = std::move(_callback);
+            lock.unlock();
+            _cv.notify_all();
+            if (callback)
+            {
+                callback();
+            }
+        }
+
+    public:
+        explicit SharedState(ContinuationExecutor executor) : _executor(std::move(executor)) {}
+        ~SharedState()
+        {
+            if (_has_value)
+            {
+                reinterpret_cast<value_type *>(&_value)->~value_type();
+            }
+        }
+        SharedState(const SharedState &) = delete;
+        SharedState &operator=(const SharedState &) = delete;
+
+        const ContinuationExecutor &executor() const { return _executor; }
+
+        template <typename V>
+        void set_value(V &&value)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_ready)
+            {
+                throw std::future_error(std::future_errc::promise_already_satisfied);
+            }
+            new (&_value) value_type(std::forward<V>(value));
+            _has_value = true;
+            complete(lock);
+        }
+
+        void set_exception(std::exception_ptr exception)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_ready)
+            {
+                throw std::future_error(std::future_errc::promise_already_satisfied);
+            }
+            _exception = exception;
+            complete(lock);
+        }
+
+        bool ready()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _ready;
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]() { return _ready; });
+        }
+
+        template <class Rep, class Period>
+        bool wait_for(const std::chrono::duration<Rep, Period> &wait_duration)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _cv.wait_for(lock, wait_duration, [this]() { return _ready; });
+        }
+
+        /**
+         * @brief 等待结果并移出, 结果是异常时重新抛出
+         */
+        value_type get()
+        {
+            wait();
+            if (_exception)
+            {
+                std::rethrow_exception(_exception);
+            }
+            return std::move(*reinterpret_cast<value_type *>(&_value));
+        }
+
+        /**
+         * @brief 注册结果就绪时的回调, 已经就绪时直接调用, 只能注册一次
+         */
+        void on_ready(UniqueTask callback)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_ready)
+            {
+                lock.unlock();
+                callback();
+                return;
+            }
+            _callback = std::move(callback);
+        }
+    };
+
+    /**
+     * @brief 调用函数并将返回值或异常设置到结果中, void返回值单独处理
+     */
+    template <typename R>
+    struct Invoker
+    {
+        template <typename F>
+        static void call(SharedState<R> &state, F &func)
+        {
+            try
+            {
+                state.set_value(func());
+            }
+            catch (...)
+            {
+                state.set_exception(std::current_exception());
+            }
+        }
+    };
+
+    template <>
+    struct Invoker<void>
+    {
+        template <typename F>
+        static void call(SharedState<void> &state, F &func)
+        {
+            try
+            {
+                func();
+                state.set_value(Unit());
+            }
+            catch (...)
+            {
+                state.set_exception(std::current_exception());
+            }
+        }
+    };
+
+    template <typename T>
+    struct Getter
+    {
+        static T get(SharedState<T> &state) { return state.get(); }
+    };
+
+    template <>
+    struct Getter<void>
+    {
+        static void get(SharedState<void> &state) { state.get(); }
+    };
+
+    //构造Future, Future从SharedState构造的构造函数不公开
+    struct Access
+    {
+        template <typename T>
+        static Future<T> make(std::shared_ptr<SharedState<T>> state)
+        {
+            return Future<T>(std::move(state));
+        }
+
+        template <typename T>
+        static const std::shared_ptr<SharedState<T>> &state(const Future<T> &future)
+        {
+            return future._state;
+        }
+    };
+
+    /**
+     * @brief 把前一个结果作为Future传给后续函数, 并设置后续函数的结果
+     */
+    template <typename T, typename R, typename F>
+    struct ContinuationTask
+    {
+        std::shared_ptr<SharedState<T>> state;
+        std::shared_ptr<SharedState<R>> next;
+        F func;
+
+        void operator()()
+        {
+            std::shared_ptr<SharedState<T>> prev = std::move(state);
+            auto call = [&]() { return func(Access::make(std::move(prev))); };
+            Invoker<R>::call(*next, call);
+        }
+    };
+
+    /**
+     * @brief 前一个结果就绪时, 通过executor执行ContinuationTask
+     *        回调保存在前一个结果中, 只持有它的weak_ptr, 避免循环引用, 只会被调用一次, 可以移走成员
+     */
+    template <typename T, typename R, typename F>
+    struct Continuation
+    {
+        std::weak_ptr<SharedState<T>> state;
+        std::shared_ptr<SharedState<R>> next;
+        F func;
+
+        void operator()()
+        {
+            //task在当前线程执行时可能释放前一个结果, executor属于前一个结果, 先持有它
+            std::shared_ptr<SharedState<T>> prev = state.lock();
+            ContinuationTask<T, R, F> task{prev, std::move(next), std::move(func)};
+            const ContinuationExecutor &executor = prev->executor();
+            if (executor)
+            {
+                executor(UniqueTask(std::move(task)));
+            }
+            else
+            {
+                task();
+            }
+        }
+    };
+
+    template <typename T>
+    struct WhenAllContext
+    {
+        std::vector<Future<T>> futures;
+        std::atomic<std::size_t> remaining;
+        std::shared_ptr<SharedState<std::vector<Future<T>>>> result;
+    };
+
+    template <typename T>
+    struct WhenAllCallback
+    {
+        std::shared_ptr<WhenAllContext<T>> ctx;
+
+        void operator()()
+        {
+            if (ctx->remaining.fetch_sub(1) == 1)
+            {
+                ctx->result->set_value(std::move(ctx->futures));
+            }
+        }
+    };
+}
+
+/**
+ * @brief when_any的结果
+ *
+ * @tparam T Future的结果类型
+ */
+template <typename T>
+struct WhenAnyResult
+{
+    //第一个就绪的Future的下标
+    std::size_t index;
+    std::vector<Future<T>> futures;
+};
+
+namespace future_detail
+{
+    template <typename T>
+    struct WhenAnyContext
+    {
+        std::vector<Future<T>> futures;
+        std::atomic<bool> done{false};
+        std::shared_ptr<SharedState<WhenAnyResult<T>>> result;
+    };
+
+    template <typename T>
+    struct WhenAnyCallback
+    {
+        std::shared_ptr<WhenAnyContext<T>> ctx;
+        std::size_t index;
+
+        void operator()()
+        {
+            if (!ctx->done.exchange(true))
+            {
+                ctx->result->set_value(WhenAnyResult<T>{index, std::move(ctx->futures)});
+            }
+        }
+    };
+}
+
+/**
+ * @brief 异步结果, 只能移动, get或then之后不再可用
+ *        与std::future不同, 可以用then注册后续任务, 结果就绪后由创建时指定的ContinuationExecutor执行, 不需要阻塞线程等待
+ *
+ * @tparam T 结果类型
+ */
+template <typename T>
+class Future
+{
+private:
+    friend struct future_detail::Access;
+    template <typename U>
+    friend class Promise;
+
+    std::shared_ptr<future_detail::SharedState<T>> _state;
+
+    explicit Future(std::shared_ptr<future_detail::SharedState<T>> state) : _state(std::move(state)) {}
+    void check() const
+    {
+        if (!_state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+    }
+
+public:
+    typedef T value_type;
+
+    Future() = default;
+    Future(Future &&) = default;
+    Future &operator=(Future &&) = default;
+    Future(const Future &) = delete;
+    Future &operator=(const Future &) = delete;
+
+    /**
+     * @brief 是否关联了结果
+     */
+    bool valid() const;
+    /**
+     * @brief 结果是否就绪
+     */
+    bool ready() const;
+    /**
+     * @brief 阻塞到结果就绪
+     */
+    void wait() const;
+    /**
+     * @brief 阻塞到结果就绪或超时
+     *
+     * @tparam Rep 时间单位的类型
+     * @tparam Period 时间单位
+     * @param wait_duration 等待时间
+     * @return true 结果就绪
+     * @return false 超时
+     */
+    template <class Rep, class Period>
+    bool wait_for(const std::chrono::duration<Rep, Period> &wait_duration) const;
+    /**
+     * @brief 阻塞到结果就绪并返回结果, 结果是异常时重新抛出, 调用后Future不再可用
+     */
+    T get();
+    /**
+     * @brief 注册后续任务, 结果就绪后以就绪的Future为参数调用func, 调用后Future不再可用
+     *        func抛出的异常设置到返回的Future中
+     *
+     * @tparam F 可调用对象, 参数为Future<T>, 可以只能移动
+     * @param func 后续任务
+     * @return Future<R> func的返回值
+     */
+    template <typename F>
+    Future<typename std::result_of<F(Future<T>)>::type> then(F &&func);
+};
+
+template <typename T>
+bool Future<T>::valid() const
+{
+    return _state != nullptr;
+}
+
+template <typename T>
+bool Future<T>::ready() const
+{
+    check();
+    return _state->ready();
+}
+
+template <typename T>
+void Future<T>::wait() const
+{
+    check();
+    _state->wait();
+}
+
+template <typename T>
+template <class Rep, class Period>
+bool Future<T>::wait_for(const std::chrono::duration<Rep, Period> &wait_duration) const
+{
+    check();
+    return _state->wait_for(wait_duration);
+}
+
+template <typename T>
+T Future<T>::get()
+{
+    check();
+    std::shared_ptr<future_detail::SharedState<T>> state = std::move(_state);
+    return future_detail::Getter<T>::get(*state);
+}
+
+template <typename T>
+template <typename F>
+Future<typename std::result_of<F(Future<T>)>::type> Future<T>::then(F &&func)
+{
+    typedef typename std::result_of<F(Future<T>)>::type R;
+    typedef typename std::decay<F>::type Func;
+    check();
+    std::shared_ptr<future_detail::SharedState<T>> state = std::move(_state);
+    auto next = std::make_shared<future_detail::SharedState<R>>(state->executor());
+    state->on_ready(UniqueTask(future_detail::Continuation<T, R, Func>{state, next, std::forward<F>(func)}));
+    return future_detail::Access::make(next);
+}
+
+/**
+ * @brief 设置Future的结果, 只能移动, 析构时还没有设置结果则设置std::future_errc::broken_promise异常
+ *
+ * @tparam T 结果类型
+ */
+template <typename T>
+class Promise
+{
+private:
+    std::shared_ptr<future_detail::SharedState<T>> _state;
+    bool _retrieved = false;
+
+    void check() const
+    {
+        if (!_state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+    }
+
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param executor 执行then注册的后续任务, 为空时在设置结果的线程中执行
+     */
+    explicit Promise(ContinuationExecutor executor = ContinuationExecutor());
+    ~Promise();
+    Promise(Promise &&) = default;
+    Promise &operator=(Promise &&other);
+    Promise(const Promise &) = delete;
+    Promise &operator=(const Promise &) = delete;
+
+    /**
+     * @brief 获取关联的Future, 只能获取一次
+     */
+    Future<T> get_future();
+    /**
+     * @brief 设置结果, T为void时没有参数
+     */
+    template <typename... V>
+    void set_value(V &&...value);
+    void set_exception(std::exception_ptr exception);
+    /**
+     * @brief 调用func, 将返回值或抛出的异常设置为结果
+     */
+    template <typename F>
+    void set_with(F &&func);
+};
+
+template <typename T>
+Promise<T>::Promise(ContinuationExecutor executor)
+    : _state(std::make_shared<future_detail::SharedState<T>>(std::move(executor))) {}
+
+template <typename T>
+Promise<T>::~Promise()
+{
+    if (_state && !_state->ready())
+    {
+        _state->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+    }
+}
+
+template <typename T>
+Promise<T> &Promise<T>::operator=(Promise &&other)
+{
+    if (this != &other)
+    {
+        Promise tmp(std::move(*this));
+        _state = std::move(other._state);
+        _retrieved = other._retrieved;
+    }
+    return *this;
+}
+
+template <typename T>
+Future<T> Promise<T>::get_future()
+{
+    check();
+    if (_retrieved)
+    {
+        throw std::future_error(std::future_errc::future_already_retrieved);
+    }
+    _retrieved = true;
+    return Future<T>(_state);
+}
+
+template <typename T>
+template <typename... V>
+void Promise<T>::set_value(V &&...value)
+{
+    check();
+    _state->set_value(typename future_detail::SharedState<T>::value_type(std::forward<V>(value)...));
+}
+
+template <typename T>
+void Promise<T>::set_exception(std::exception_ptr exception)
+{
+    check();
+    _state->set_exception(exception);
+}
+
+template <typename T>
+template <typename F>
+void Promise<T>::set_with(F &&func)
+{
+    check();
+    future_detail::Invoker<T>::call(*_state, func);
+}
+
+namespace future_detail
+{
+    /**
+     * @brief 在线程池中执行的任务, 将func的结果设置到promise
+     *        只能移动, 直接保存promise, 放入UniqueTask队列时不超过UniqueTask::INLINE_SIZE字节不需要申请内存
+     *        任务没有执行就被释放时promise析构, 设置broken_promise
+     */
+    template <typename R, typename F>
+    struct PromiseTask
+    {
+        Promise<R> promise;
+        F func;
+
+        void operator()()
+        {
+            promise.set_with(func);
+        }
+    };
+}
+
+/**
+ * @brief 所有Future都就绪后, 返回的Future就绪, 结果为传入的Future
+ *        后续任务由第一个Future的ContinuationExecutor执行
+ *
+ * @tparam T Future的结果类型
+ * @param futures 等待的Future
+ * @return Future<std::vector<Future<T>>> 所有Future都就绪的Future
+ */
+template <typename T>
+Future<std::vector<Future<T>>> when_all(std::vector<Future<T>> futures)
+{
+    typedef future_detail::SharedState<std::vector<Future<T>>> State;
+    ContinuationExecutor executor;
+    if (!futures.empty() && future_detail::Access::state(futures[0]))
+    {
+        executor = future_detail::Access::state(futures[0])->executor();
+    }
+    auto result = std::make_shared<State>(std::move(executor));
+    if (futures.empty())
+    {
+        result->set_value(std::vector<Future<T>>());
+        return future_detail::Access::make(result);
+    }
+    //回调可能在注册时直接执行并移走futures, 所以先取出所有结果
+    std::vector<std::shared_ptr<future_detail::SharedState<T>>> states;
+    for (auto &future : futures)
+    {
+        if (!future.valid())
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        states.push_back(future_detail::Access::state(future));
+    }
+    auto ctx = std::make_shared<future_detail::WhenAllContext<T>>();
+    ctx->futures = std::move(futures);
+    ctx->remaining.store(states.size());
+    ctx->result = result;
+    for (auto &state : states)
+    {
+        state->on_ready(future_detail::WhenAllCallback<T>{ctx});
+    }
+    return future_detail::Access::make(result);
+}
+
+/**
+ * @brief 任意一个Future就绪后, 返回的Future就绪, 结果为就绪的下标和传入的Future
+ *        后续任务由第一个Future的ContinuationExecutor执行
+ *
+ * @tparam T Future的结果类型
+ * @param futures 等待的Future, 不能为空
+ * @return Future<WhenAnyResult<T>> 任意一个Future就绪的Future
+ */
+template <typename T>
+Future<WhenAnyResult<T>> when_any(std::vector<Future<T>> futures)
+{
+    typedef future_detail::SharedState<WhenAnyResult<T>> State;
+    if (futures.empty())
+    {
+        throw std::future_error(std::future_errc::no_state);
+    }
+    std::vector<std::shared_ptr<future_detail::SharedState<T>>> states;
+    for (auto &future : futures)
+    {
+        if (!future.valid())
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        states.push_back(future_detail::Access::state(future));
+    }
+    auto result = std::make_shared<State>(states[0]->executor());
+    auto ctx = std::make_shared<future_detail::WhenAnyContext<T>>();
+    ctx->futures = std::move(futures);
+    ctx->result = result;
+    for (std::size_t i = 0; i < states.size(); i++)
+    {
+        states[i]->on_ready(future_detail::WhenAnyCallback<T>{ctx, i});
+    }
+    return future_detail::Access::make(result);
+}
+
+#endif /* __FUTURE_HPP__ */
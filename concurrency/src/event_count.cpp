@@ -0,0 +1,94 @@
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <ctime>
+
+#include "concurrency/event_count.hpp"
+
+namespace
+{
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be 32 bits");
+
+    int futex_wait(std::atomic<std::uint32_t> *addr, std::uint32_t expected, const struct timespec *timeout)
+    {
+        return syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(addr), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+    }
+
+    void futex_wake(std::atomic<std::uint32_t> *addr, int n)
+    {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(addr), FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+    }
+}
+
+EventCount::Key EventCount::prepare_wait()
+{
+    _waiters.fetch_add(1, std::memory_order_relaxed);
+    //与notify中的fence配对: 要么通知方看到等待者, 要么等待者随后检查条件时看到修改
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return _epoch.load(std::memory_order_acquire);
+}
+
+void EventCount::cancel_wait()
+{
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EventCount::wait(Key key)
+{
+    while (_epoch.load(std::memory_order_acquire) == key)
+    {
+        //值已改变(EAGAIN)或被信号打断(EINTR)时重新检查
+        futex_wait(&_epoch, key, nullptr);
+    }
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool EventCount::wait_for(Key key, std::chrono::nanoseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool res = true;
+    while (_epoch.load(std::memory_order_acquire) == key)
+    {
+        auto left = deadline - std::chrono::steady_clock::now();
+        if (left <= std::chrono::nanoseconds::zero())
+        {
+            res = false;
+            break;
+        }
+        auto sec = std::chrono::duration_cast<std::chrono::seconds>(left);
+        struct timespec ts;
+        ts.tv_sec = (time_t)sec.count();
+        ts.tv_nsec = (long)std::chrono::duration_cast<std::chrono::nanoseconds>(left - sec).count();
+        if (futex_wait(&_epoch, key, &ts) != 0 && errno == ETIMEDOUT)
+        {
+            res = _epoch.load(std::memory_order_acquire) != key;
+            break;
+        }
+    }
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+    return res;
+}
+
+void EventCount::notify_one()
+{
+    notify(1);
+}
+
+void EventCount::notify_all()
+{
+    notify(INT_MAX);
+}
+
+void EventCount::notify(int n)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiters.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    _epoch.fetch_add(1, std::memory_order_release);
+    futex_wake(&_epoch, n);
+}
@@ -4,6 +4,7 @@
 
 void PriorityExecutor::run()
 {
+    std::size_t spins = spin();
     while (1)
     {
         std::pair<std::shared_ptr<ExecutorTask>, int> task;
@@ -11,7 +12,10 @@ void PriorityExecutor::run()
         {
         case this->RUNNING:
         {
-            if (_task_queue->wait_pop(task, std::chrono::milliseconds(10)))
+            //没有任务时休眠, 直到放入任务或phase改变
+            if (_task_queue->try_pop(task) ||
+                idle_wait([&]() { return _task_queue->try_pop(task); },
+                          [&]() { return !_task_queue->empty(); }, spins))
             {
                 task.first->run();
             }
@@ -42,7 +46,11 @@ void PriorityExecutor::run()
 PriorityExecutor::PriorityExecutor(std::size_t threads, std::shared_ptr<ThreadFactory> thread_factory)
     : Executor(threads, thread_factory) {}
 
-PriorityExecutor::~PriorityExecutor() {}
+PriorityExecutor::~PriorityExecutor()
+{
+    //run是虚函数, 必须在派生类析构之前等待任务线程结束
+    _threads.clear();
+}
 
 bool PriorityExecutor::execute(int priority, std::shared_ptr<ExecutorTask> task)
 {
@@ -53,6 +61,7 @@ bool PriorityExecutor::execute(int priority, std::shared_ptr<ExecutorTask> task)
     else
     {
         _task_queue->push(std::pair<std::shared_ptr<ExecutorTask>, int>(task, priority));
+        notify_task();
         return true;
     }
 }
@@ -66,6 +75,7 @@ bool PriorityExecutor::execute(int priority, std::function<void()> &&task)
     else
     {
         _task_queue->push(std::make_pair<>(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), priority));
+        notify_task();
         return true;
     }
 }
@@ -78,7 +88,12 @@ bool PriorityExecutor::try_execute(int priority, std::shared_ptr<ExecutorTask> t
     }
     else
     {
-        return _task_queue->try_push(std::pair<std::shared_ptr<ExecutorTask>, int>(task, priority));
+        if (_task_queue->try_push(std::pair<std::shared_ptr<ExecutorTask>, int>(task, priority)))
+        {
+            notify_task();
+            return true;
+        }
+        return false;
     }
 }
 
@@ -90,6 +105,11 @@ bool PriorityExecutor::try_execute(int priority, std::function<void()> &&task)
     }
     else
     {
-        return _task_queue->try_push(std::make_pair<>(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), priority));
+        if (_task_queue->try_push(std::make_pair<>(std::make_shared<FunctionExecutorTask>(std::forward<std::function<void()>>(task)), priority)))
+        {
+            notify_task();
+            return true;
+        }
+        return false;
     }
 }
\ No newline at end of file
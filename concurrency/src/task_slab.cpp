@@ -0,0 +1,205 @@
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "concurrency/executor/task_slab.hpp"
+
+namespace
+{
+    const std::size_t MIN_SIZE = 64;
+    const std::size_t CLASS_NUM = 4;
+    //线程缓存与全局空闲链表之间每次移动的块数, 也是每个slab的块数
+    const std::size_t BATCH = 32;
+    //线程缓存的最大块数, 超过后返还一批
+    const std::size_t MAX_CACHE = BATCH * 2;
+
+    struct Node
+    {
+        Node *next;
+    };
+
+    std::size_t size_index(std::size_t size)
+    {
+        std::size_t index = 0;
+        for (std::size_t block = MIN_SIZE; block < size; block <<= 1)
+        {
+            index++;
+        }
+        return index;
+    }
+
+    std::size_t block_size(std::size_t index)
+    {
+        return MIN_SIZE << index;
+    }
+
+    class Central
+    {
+    private:
+        struct Slot
+        {
+            std::mutex mutex;
+            Node *head = nullptr;
+        };
+
+        Slot _slots[CLASS_NUM];
+        std::mutex _slabs_mutex;
+        std::vector<void *> _slabs;
+
+    public:
+        ~Central()
+        {
+            for (void *slab : _slabs)
+            {
+                ::operator delete(slab);
+            }
+        }
+
+        /**
+         * @brief 取出最多BATCH个块, 为空时申请一个slab
+         *
+         * @param index 大小分级
+         * @param n 取出的块数
+         * @return Node* 以nullptr结尾的链表
+         */
+        Node *remove_batch(std::size_t index, std::size_t &n)
+        {
+            Slot &slot = _slots[index];
+            {
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                if (slot.head != nullptr)
+                {
+                    Node *first = slot.head;
+                    Node *last = first;
+                    n = 1;
+                    while (n < BATCH && last->next != nullptr)
+                    {
+                        last = last->next;
+                        n++;
+                    }
+                    slot.head = last->next;
+                    last->next = nullptr;
+                    return first;
+                }
+            }
+            std::size_t size = block_size(index);
+            char *slab = static_cast<char *>(::operator new(size * BATCH));
+            {
+                std::lock_guard<std::mutex> lock(_slabs_mutex);
+                _slabs.push_back(slab);
+            }
+            for (std::size_t i = 0; i < BATCH; i++)
+            {
+                reinterpret_cast<Node *>(slab + i * size)->next = i + 1 < BATCH ? reinterpret_cast<Node *>(slab + (i + 1) * size) : nullptr;
+            }
+            n = BATCH;
+            return reinterpret_cast<Node *>(slab);
+        }
+
+        void insert_batch(std::size_t index, Node *first, Node *last)
+        {
+            Slot &slot = _slots[index];
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            last->next = slot.head;
+            slot.head = first;
+        }
+    };
+
+    Central &central()
+    {
+        static Central res;
+        return res;
+    }
+
+    class ThreadCache
+    {
+    private:
+        struct List
+        {
+            Node *head = nullptr;
+            std::size_t length = 0;
+        };
+
+        List _lists[CLASS_NUM];
+
+        //返还n个块, n为0时返还全部
+        void release(std::size_t index, std::size_t n)
+        {
+            List &list = _lists[index];
+            if (list.head == nullptr)
+            {
+                return;
+            }
+            Node *first = list.head;
+            Node *last = first;
+            std::size_t count = 1;
+            while ((n == 0 || count < n) && last->next != nullptr)
+            {
+                last = last->next;
+                count++;
+            }
+            list.head = last->next;
+            list.length -= count;
+            central().insert_batch(index, first, last);
+        }
+
+    public:
+        ~ThreadCache()
+        {
+            for (std::size_t i = 0; i < CLASS_NUM; i++)
+            {
+                release(i, 0);
+            }
+        }
+
+        void *allocate(std::size_t index)
+        {
+            List &list = _lists[index];
+            if (list.head == nullptr)
+            {
+                list.head = central().remove_batch(index, list.length);
+            }
+            Node *node = list.head;
+            list.head = node->next;
+            list.length--;
+            return node;
+        }
+
+        void deallocate(std::size_t index, void *p)
+        {
+            List &list = _lists[index];
+            Node *node = static_cast<Node *>(p);
+            node->next = list.head;
+            list.head = node;
+            if (++list.length > MAX_CACHE)
+            {
+                release(index, BATCH);
+            }
+        }
+    };
+
+    ThreadCache &thread_cache()
+    {
+        static thread_local ThreadCache res;
+        return res;
+    }
+}
+
+void *TaskSlab::allocate(std::size_t size)
+{
+    if (size > MAX_SIZE)
+    {
+        return ::operator new(size);
+    }
+    return thread_cache().allocate(size_index(size));
+}
+
+void TaskSlab::deallocate(void *p, std::size_t size)
+{
+    if (size > MAX_SIZE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    thread_cache().deallocate(size_index(size), p);
+}
@@ -0,0 +1,58 @@
+#include "concurrency/executor/unique_task.hpp"
+
+UniqueTask::UniqueTask() noexcept {}
+
+UniqueTask::UniqueTask(std::nullptr_t) noexcept {}
+
+UniqueTask::UniqueTask(UniqueTask &&other) noexcept : _ops(other._ops)
+{
+    if (_ops != nullptr)
+    {
+        _ops->move(&_storage, &other._storage);
+        other._ops = nullptr;
+    }
+}
+
+UniqueTask &UniqueTask::operator=(UniqueTask &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        if (other._ops != nullptr)
+        {
+            other._ops->move(&_storage, &other._storage);
+            _ops = other._ops;
+            other._ops = nullptr;
+        }
+    }
+    return *this;
+}
+
+UniqueTask::~UniqueTask()
+{
+    reset();
+}
+
+void UniqueTask::operator()()
+{
+    _ops->invoke(&_storage);
+}
+
+UniqueTask::operator bool() const noexcept
+{
+    return _ops != nullptr;
+}
+
+bool UniqueTask::is_inline() const noexcept
+{
+    return _ops != nullptr && !_ops->on_heap;
+}
+
+void UniqueTask::reset() noexcept
+{
+    if (_ops != nullptr)
+    {
+        _ops->destroy(&_storage);
+        _ops = nullptr;
+    }
+}